@@ -0,0 +1,141 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSBulkEdit.h"
+#include "PSData.h"
+#include "PSPropertyCache.h"
+
+#include "Editor.h"
+#include "Engine/Selection.h"
+#include "HAL/IConsoleManager.h"
+#include "ScopedTransaction.h"
+
+#define LOCTEXT_NAMESPACE "PSBulkEdit"
+
+namespace
+{
+	FAutoConsoleCommand BulkEditCommand(
+		TEXT("ps.BulkEdit"),
+		TEXT("Sets a variable on every selected actor, as a single undo step. Usage: ps.BulkEdit VarName Value"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			if (Args.Num() < 2)
+			{
+				return;
+			}
+
+			// Struct values like (X=1, Y=2) get split on their spaces, put them back together
+			TArray<FString> ValueArgs(Args);
+			ValueArgs.RemoveAt(0);
+			FPSBulkEdit::ApplyToSelection(FName(*Args[0]), FString::Join(ValueArgs, TEXT(" ")));
+		}));
+
+	// Parses Value into a scratch value, the same way UPSData::SetValuesFromStringByName will, without touching any object
+	bool ParsesAs(const UProperty* Property, const FString& Value)
+	{
+		if (Property->ArrayDim != 1)
+		{
+			return false;
+		}
+
+		void* Scratch = FMemory::Malloc(Property->GetSize(), Property->GetMinAlignment());
+		Property->InitializeValue(Scratch);
+		const bool bParsed = Property->ImportText(*Value, Scratch, PPF_None, nullptr) != nullptr;
+		Property->DestroyValue(Scratch);
+		FMemory::Free(Scratch);
+		return bParsed;
+	}
+}
+
+int32 FPSBulkEdit::Apply(const TArray<UObject*>& Targets, FName VarName, const FString& Value)
+{
+	// Resolve the property and parse the value once per class, only objects the value can go into take part in the edit
+	TArray<UObject*> EditTargets;
+	TArray<UProperty*> EditProperties;
+	EditTargets.Reserve(Targets.Num());
+	EditProperties.Reserve(Targets.Num());
+
+	const UClass* LastClass = nullptr;
+	UProperty* LastProperty = nullptr;
+	TMap<const UProperty*, bool> Parsed;
+
+	for (UObject* Target : Targets)
+	{
+		if (!Target)
+		{
+			continue;
+		}
+
+		if (Target->GetClass() != LastClass)
+		{
+			LastClass = Target->GetClass();
+			LastProperty = FPSPropertyCache::FindProperty(LastClass, VarName);
+
+			// Classes sharing the variable (e.g. it's declared on a common parent) share the parse
+			if (LastProperty)
+			{
+				bool* bParsed = Parsed.Find(LastProperty);
+				if (!bParsed)
+				{
+					bParsed = &Parsed.Add(LastProperty, ParsesAs(LastProperty, Value));
+				}
+
+				if (!*bParsed)
+				{
+					LastProperty = nullptr;
+				}
+			}
+		}
+
+		if (LastProperty)
+		{
+			EditTargets.Add(Target);
+			EditProperties.Add(LastProperty);
+		}
+	}
+
+	if (EditTargets.Num() == 0)
+	{
+		// Nothing has the variable or the value doesn't parse for it, leave every object (and the undo buffer) alone
+		return 0;
+	}
+
+	FScopedTransaction Transaction(FText::Format(LOCTEXT("BulkEditTransaction", "Set {0} on {1} Objects"), FText::FromName(VarName), FText::AsNumber(EditTargets.Num())));
+
+	for (int32 Index = 0; Index < EditTargets.Num(); ++Index)
+	{
+		EditTargets[Index]->Modify();
+		EditTargets[Index]->PreEditChange(EditProperties[Index]);
+	}
+
+	const int32 NumSet = UPSData::SetValuesFromStringByName(EditTargets, VarName, Value);
+
+	// Only now let listeners (and actor construction scripts) react, once per object and with every value already in place
+	for (int32 Index = 0; Index < EditTargets.Num(); ++Index)
+	{
+		FPropertyChangedEvent ChangedEvent(EditProperties[Index], EPropertyChangeType::ValueSet);
+		EditTargets[Index]->PostEditChangeProperty(ChangedEvent);
+	}
+
+	return NumSet;
+}
+
+int32 FPSBulkEdit::ApplyToSelection(FName VarName, const FString& Value)
+{
+	if (!GEditor)
+	{
+		return 0;
+	}
+
+	TArray<UObject*> Targets;
+	GEditor->GetSelectedActors()->GetSelectedObjects(Targets);
+
+	const int32 NumSet = Apply(Targets, VarName, Value);
+	if (NumSet > 0)
+	{
+		GEditor->RedrawLevelEditingViewports();
+	}
+	return NumSet;
+}
+
+#undef LOCTEXT_NAMESPACE
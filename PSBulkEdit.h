@@ -0,0 +1,22 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Editor side bulk edit of one named variable across many objects, e.g. thousands of placed agents.
+ * The whole edit is one undo transaction: every object is modified in one pass, the values are written through
+ * UPSData::SetValuesFromStringByName, and PostEditChange is only broadcast once everything has been written.
+ * The value is parsed before anything is touched, so objects it can't go into are never modified or notified.
+ *
+ * Also available from the console as "ps.BulkEdit VarName Value", which applies to the selected actors.
+ */
+struct NFPOPULATIONSYSTEMEDITOR_API FPSBulkEdit
+{
+	/** Sets VarName to Value (in details panel text form) on every target that has it. Returns how many were set. */
+	static int32 Apply(const TArray<UObject*>& Targets, FName VarName, const FString& Value);
+
+	/** Same as Apply, on the actors selected in the level editor. */
+	static int32 ApplyToSelection(FName VarName, const FString& Value);
+};
@@ -0,0 +1,340 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSBulkOps.h"
+
+namespace
+{
+	// Runs VectorKernel four floats at a time, then ScalarKernel over whatever is left
+	template<typename VectorKernelType, typename ScalarKernelType>
+	FORCEINLINE void RunFloatKernel(float* Data, int32 Num, VectorKernelType VectorKernel, ScalarKernelType ScalarKernel)
+	{
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			VectorStore(VectorKernel(VectorLoad(Data + Index)), Data + Index);
+		}
+
+		for (; Index < Num; ++Index)
+		{
+			Data[Index] = ScalarKernel(Data[Index]);
+		}
+	}
+
+	// Four lane compare, every set bit of the returned mask is a match
+	template<typename VectorCompareType, typename ScalarCompareType>
+	FORCEINLINE void RunFloatCompare(const float* Data, int32 Num, float Operand, TArray<int32>& OutIndices, VectorCompareType VectorCompare, ScalarCompareType ScalarCompare)
+	{
+		const VectorRegister VecOperand = VectorSetFloat1(Operand);
+
+		int32 Index = 0;
+		for (; Index + 4 <= Num; Index += 4)
+		{
+			int32 Mask = VectorMaskBits(VectorCompare(VectorLoad(Data + Index), VecOperand));
+			while (Mask)
+			{
+				const int32 Lane = FMath::CountTrailingZeros(Mask);
+				OutIndices.Add(Index + Lane);
+				Mask &= Mask - 1;
+			}
+		}
+
+		for (; Index < Num; ++Index)
+		{
+			if (ScalarCompare(Data[Index], Operand))
+			{
+				OutIndices.Add(Index);
+			}
+		}
+	}
+
+	template<typename ValueType, typename ScalarCompareType>
+	FORCEINLINE void RunScalarCompare(const ValueType* Data, int32 Num, ValueType Operand, TArray<int32>& OutIndices, ScalarCompareType ScalarCompare)
+	{
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			if (ScalarCompare(Data[Index], Operand))
+			{
+				OutIndices.Add(Index);
+			}
+		}
+	}
+}
+
+void FPSBulkOps::Add(float* Data, int32 Num, float Value)
+{
+	const VectorRegister VecValue = VectorSetFloat1(Value);
+	RunFloatKernel(Data, Num,
+		[VecValue](VectorRegister V) { return VectorAdd(V, VecValue); },
+		[Value](float X) { return X + Value; });
+}
+
+void FPSBulkOps::Scale(float* Data, int32 Num, float Factor)
+{
+	const VectorRegister VecFactor = VectorSetFloat1(Factor);
+	RunFloatKernel(Data, Num,
+		[VecFactor](VectorRegister V) { return VectorMultiply(V, VecFactor); },
+		[Factor](float X) { return X * Factor; });
+}
+
+void FPSBulkOps::Clamp(float* Data, int32 Num, float Min, float Max)
+{
+	const VectorRegister VecMin = VectorSetFloat1(Min);
+	const VectorRegister VecMax = VectorSetFloat1(Max);
+	RunFloatKernel(Data, Num,
+		[VecMin, VecMax](VectorRegister V) { return VectorMin(VectorMax(V, VecMin), VecMax); },
+		[Min, Max](float X) { return FMath::Min(FMath::Max(X, Min), Max); });
+}
+
+void FPSBulkOps::Lerp(float* Data, int32 Num, float Target, float Alpha)
+{
+	// X + (Target - X) * Alpha == X * (1 - Alpha) + Target * Alpha, which is a single multiply-add per lane
+	Fma(Data, Num, 1.f - Alpha, Target * Alpha);
+}
+
+void FPSBulkOps::Fma(float* Data, int32 Num, float Multiplier, float Addend)
+{
+	const VectorRegister VecMultiplier = VectorSetFloat1(Multiplier);
+	const VectorRegister VecAddend = VectorSetFloat1(Addend);
+	RunFloatKernel(Data, Num,
+		[VecMultiplier, VecAddend](VectorRegister V) { return VectorMultiplyAdd(V, VecMultiplier, VecAddend); },
+		[Multiplier, Addend](float X) { return X * Multiplier + Addend; });
+}
+
+void FPSBulkOps::Add(int32* Data, int32 Num, int32 Value)
+{
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Data[Index] += Value;
+	}
+}
+
+void FPSBulkOps::Scale(int32* Data, int32 Num, int32 Factor)
+{
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Data[Index] *= Factor;
+	}
+}
+
+void FPSBulkOps::Clamp(int32* Data, int32 Num, int32 Min, int32 Max)
+{
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Data[Index] = FMath::Min(FMath::Max(Data[Index], Min), Max);
+	}
+}
+
+void FPSBulkOps::Fma(int32* Data, int32 Num, int32 Multiplier, int32 Addend)
+{
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Data[Index] = Data[Index] * Multiplier + Addend;
+	}
+}
+
+void FPSBulkOps::Apply(float* Data, int32 Num, EPSBulkOp Op, float A, float B)
+{
+	switch (Op)
+	{
+	case EPSBulkOp::Add:	Add(Data, Num, A); break;
+	case EPSBulkOp::Scale:	Scale(Data, Num, A); break;
+	case EPSBulkOp::Clamp:	Clamp(Data, Num, A, B); break;
+	case EPSBulkOp::Lerp:	Lerp(Data, Num, A, B); break;
+	case EPSBulkOp::Fma:	Fma(Data, Num, A, B); break;
+	}
+}
+
+bool FPSBulkOps::Apply(int32* Data, int32 Num, EPSBulkOp Op, int32 A, int32 B)
+{
+	switch (Op)
+	{
+	case EPSBulkOp::Add:	Add(Data, Num, A); return true;
+	case EPSBulkOp::Scale:	Scale(Data, Num, A); return true;
+	case EPSBulkOp::Clamp:	Clamp(Data, Num, A, B); return true;
+	case EPSBulkOp::Fma:	Fma(Data, Num, A, B); return true;
+	default:				return false;
+	}
+}
+
+void FPSBulkOps::Compare(const float* Data, int32 Num, EPSCompareOp Op, float Operand, TArray<int32>& OutIndices)
+{
+	switch (Op)
+	{
+	case EPSCompareOp::Less:
+		RunFloatCompare(Data, Num, Operand, OutIndices, [](VectorRegister V, VectorRegister O) { return VectorCompareGT(O, V); }, [](float X, float O) { return X < O; });
+		break;
+	case EPSCompareOp::LessOrEqual:
+		RunFloatCompare(Data, Num, Operand, OutIndices, [](VectorRegister V, VectorRegister O) { return VectorCompareGE(O, V); }, [](float X, float O) { return X <= O; });
+		break;
+	case EPSCompareOp::Greater:
+		RunFloatCompare(Data, Num, Operand, OutIndices, [](VectorRegister V, VectorRegister O) { return VectorCompareGT(V, O); }, [](float X, float O) { return X > O; });
+		break;
+	case EPSCompareOp::GreaterOrEqual:
+		RunFloatCompare(Data, Num, Operand, OutIndices, [](VectorRegister V, VectorRegister O) { return VectorCompareGE(V, O); }, [](float X, float O) { return X >= O; });
+		break;
+	case EPSCompareOp::Equal:
+		RunFloatCompare(Data, Num, Operand, OutIndices, [](VectorRegister V, VectorRegister O) { return VectorCompareEQ(V, O); }, [](float X, float O) { return X == O; });
+		break;
+	case EPSCompareOp::NotEqual:
+		RunFloatCompare(Data, Num, Operand, OutIndices, [](VectorRegister V, VectorRegister O) { return VectorCompareNE(V, O); }, [](float X, float O) { return X != O; });
+		break;
+	}
+}
+
+void FPSBulkOps::Compare(const int32* Data, int32 Num, EPSCompareOp Op, int32 Operand, TArray<int32>& OutIndices)
+{
+	switch (Op)
+	{
+	case EPSCompareOp::Less:			RunScalarCompare(Data, Num, Operand, OutIndices, [](int32 X, int32 O) { return X < O; }); break;
+	case EPSCompareOp::LessOrEqual:		RunScalarCompare(Data, Num, Operand, OutIndices, [](int32 X, int32 O) { return X <= O; }); break;
+	case EPSCompareOp::Greater:			RunScalarCompare(Data, Num, Operand, OutIndices, [](int32 X, int32 O) { return X > O; }); break;
+	case EPSCompareOp::GreaterOrEqual:	RunScalarCompare(Data, Num, Operand, OutIndices, [](int32 X, int32 O) { return X >= O; }); break;
+	case EPSCompareOp::Equal:			RunScalarCompare(Data, Num, Operand, OutIndices, [](int32 X, int32 O) { return X == O; }); break;
+	case EPSCompareOp::NotEqual:		RunScalarCompare(Data, Num, Operand, OutIndices, [](int32 X, int32 O) { return X != O; }); break;
+	}
+}
+
+void FPSBulkOps::RadixSort(TArray<uint64>& Keys, TArray<int32>& Payload)
+{
+	check(Keys.Num() == Payload.Num());
+
+	const int32 Num = Keys.Num();
+	if (Num < 2)
+	{
+		return;
+	}
+
+	// One histogram per byte, all built in a single read of the keys
+	TArray<int32> Histograms;
+	Histograms.SetNumZeroed(8 * 256);
+	for (uint64 Key : Keys)
+	{
+		for (int32 Pass = 0; Pass < 8; ++Pass)
+		{
+			++Histograms[Pass * 256 + ((Key >> (Pass * 8)) & 0xFF)];
+		}
+	}
+
+	TArray<uint64> ScratchKeys;
+	TArray<int32> ScratchPayload;
+	ScratchKeys.SetNumUninitialized(Num);
+	ScratchPayload.SetNumUninitialized(Num);
+
+	for (int32 Pass = 0; Pass < 8; ++Pass)
+	{
+		int32* Histogram = &Histograms[Pass * 256];
+		const int32 Shift = Pass * 8;
+
+		// Every key shares this digit, the pass wouldn't move anything
+		if (Histogram[(Keys[0] >> Shift) & 0xFF] == Num)
+		{
+			continue;
+		}
+
+		int32 Offset = 0;
+		for (int32 Digit = 0; Digit < 256; ++Digit)
+		{
+			const int32 Count = Histogram[Digit];
+			Histogram[Digit] = Offset;
+			Offset += Count;
+		}
+
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			const int32 Destination = Histogram[(Keys[Index] >> Shift) & 0xFF]++;
+			ScratchKeys[Destination] = Keys[Index];
+			ScratchPayload[Destination] = Payload[Index];
+		}
+
+		Swap(Keys, ScratchKeys);
+		Swap(Payload, ScratchPayload);
+	}
+}
+
+void FPSReductionPartial::Merge(const FPSReductionPartial& Other)
+{
+	if (Other.Count == 0)
+	{
+		return;
+	}
+
+	if (Count == 0)
+	{
+		*this = Other;
+		return;
+	}
+
+	// Chan et al. pairwise update
+	const int32 NewCount = Count + Other.Count;
+	const double Delta = Other.Mean - Mean;
+	M2 += Other.M2 + Delta * Delta * ((double)Count * (double)Other.Count / (double)NewCount);
+	Mean += Delta * ((double)Other.Count / (double)NewCount);
+	Sum += Other.Sum;
+	Count = NewCount;
+
+	if (Other.Min < Min)
+	{
+		Min = Other.Min;
+		MinIndex = Other.MinIndex;
+	}
+
+	if (Other.Max > Max)
+	{
+		Max = Other.Max;
+		MaxIndex = Other.MaxIndex;
+	}
+}
+
+FPSReductionPartial FPSBulkOps::Reduce(const double* Data, int32 Num, const int32* Indices)
+{
+	FPSReductionPartial Partial;
+	if (Num <= 0)
+	{
+		return Partial;
+	}
+
+	// Four independent accumulators so the adds don't serialize on one register
+	double Sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+	int32 MinPosition = 0;
+	int32 MaxPosition = 0;
+
+	int32 Index = 0;
+	for (; Index + 4 <= Num; Index += 4)
+	{
+		Sums[0] += Data[Index];
+		Sums[1] += Data[Index + 1];
+		Sums[2] += Data[Index + 2];
+		Sums[3] += Data[Index + 3];
+	}
+	for (; Index < Num; ++Index)
+	{
+		Sums[0] += Data[Index];
+	}
+
+	for (Index = 1; Index < Num; ++Index)
+	{
+		MinPosition = Data[Index] < Data[MinPosition] ? Index : MinPosition;
+		MaxPosition = Data[Index] > Data[MaxPosition] ? Index : MaxPosition;
+	}
+
+	Partial.Count = Num;
+	Partial.Sum = (Sums[0] + Sums[1]) + (Sums[2] + Sums[3]);
+	Partial.Mean = Partial.Sum / Num;
+
+	// The values are already dense, so a second pass gives an exact variance instead of a running one
+	double M2 = 0.0;
+	for (Index = 0; Index < Num; ++Index)
+	{
+		const double Delta = Data[Index] - Partial.Mean;
+		M2 += Delta * Delta;
+	}
+	Partial.M2 = M2;
+
+	Partial.Min = Data[MinPosition];
+	Partial.Max = Data[MaxPosition];
+	Partial.MinIndex = Indices ? Indices[MinPosition] : MinPosition;
+	Partial.MaxIndex = Indices ? Indices[MaxPosition] : MaxPosition;
+
+	return Partial;
+}
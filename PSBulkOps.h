@@ -0,0 +1,78 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PSTypes.h"
+#include "PSColumnStore.h"
+
+/** Partial reduction over a run of values. Partials of separate runs can be merged without losing precision on the variance. */
+struct NFPOPULATIONSYSTEM_API FPSReductionPartial
+{
+	int32 Count = 0;
+	double Sum = 0.0;
+	double Mean = 0.0;
+	/** Sum of squared distances from Mean */
+	double M2 = 0.0;
+	double Min = 0.0;
+	double Max = 0.0;
+	int32 MinIndex = INDEX_NONE;
+	int32 MaxIndex = INDEX_NONE;
+
+	/** Folds Other into this partial. Other must cover values that come after this one's, so ties keep the first index. */
+	void Merge(const FPSReductionPartial& Other);
+};
+
+/**
+ * In-place arithmetic kernels over contiguous values.
+ * Float kernels run four lanes at a time through VectorRegister with a scalar tail, int kernels are plain loops the compiler can vectorize.
+ */
+struct NFPOPULATIONSYSTEM_API FPSBulkOps
+{
+	static void Add(float* Data, int32 Num, float Value);
+	static void Scale(float* Data, int32 Num, float Factor);
+	static void Clamp(float* Data, int32 Num, float Min, float Max);
+	static void Lerp(float* Data, int32 Num, float Target, float Alpha);
+	static void Fma(float* Data, int32 Num, float Multiplier, float Addend);
+
+	static void Add(int32* Data, int32 Num, int32 Value);
+	static void Scale(int32* Data, int32 Num, int32 Factor);
+	static void Clamp(int32* Data, int32 Num, int32 Min, int32 Max);
+	static void Fma(int32* Data, int32 Num, int32 Multiplier, int32 Addend);
+
+	/** Runs Op over Data. A and B are the operands described on EPSBulkOp. */
+	static void Apply(float* Data, int32 Num, EPSBulkOp Op, float A, float B);
+
+	/** Lerp has no integer alpha, so it is rejected (returns false) for int data. */
+	static bool Apply(int32* Data, int32 Num, EPSBulkOp Op, int32 A, int32 B);
+
+	/** Appends the index of every value that satisfies (Value Op Operand) to OutIndices, in order. */
+	static void Compare(const float* Data, int32 Num, EPSCompareOp Op, float Operand, TArray<int32>& OutIndices);
+	static void Compare(const int32* Data, int32 Num, EPSCompareOp Op, int32 Operand, TArray<int32>& OutIndices);
+
+	/** Reduces Data into a partial. Indices are reported as Indices[i] when given, i otherwise. */
+	static FPSReductionPartial Reduce(const double* Data, int32 Num, const int32* Indices = nullptr);
+
+	/**
+	 * Stable LSD radix sort of Keys, 8 bits per pass. Payload is permuted along with the keys.
+	 * Passes where every key has the same digit are skipped, so narrow key ranges only pay for the bytes that differ.
+	 */
+	static void RadixSort(TArray<uint64>& Keys, TArray<int32>& Payload);
+
+	/** Maps a double to a key whose unsigned order matches the numeric order of the doubles. */
+	static FORCEINLINE uint64 ToSortableKey(double Value)
+	{
+		const uint64 Bits = *reinterpret_cast<const uint64*>(&Value);
+		return (Bits & (1ull << 63)) ? ~Bits : (Bits | (1ull << 63));
+	}
+
+	static void Apply(FPSFloatColumn& Column, EPSBulkOp Op, float A, float B)
+	{
+		Apply(Column.GetData(), Column.Num(), Op, A, B);
+	}
+
+	static bool Apply(FPSIntColumn& Column, EPSBulkOp Op, int32 A, int32 B)
+	{
+		return Apply(Column.GetData(), Column.Num(), Op, A, B);
+	}
+};
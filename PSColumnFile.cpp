@@ -0,0 +1,372 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSColumnFile.h"
+
+#include "PSJournal.h"
+#include "PSObservers.h"
+#include "PSPropertyCache.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/BufferReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Serialization/StructuredArchive.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	const uint32 ColumnFileMagic = 0x46435350; // "PSCF"
+	const int32 ColumnFileVersion = 1;
+
+	// Column data is staged in memory and handed to the file writer in blocks of about this size
+	const int32 WriteChunkSize = 64 * 1024;
+
+	struct FColumnSchema
+	{
+		FString VarName;
+
+		/** C++ type of the property, e.g. "float" or "TArray<FName>". Catches retyped variables, including struct and container changes. */
+		FString PropertyType;
+
+		/** Size of one complete value (all static array elements). */
+		int32 ValueSize = 0;
+
+		/** Raw columns are the values back to back with a fixed stride, others are each value serialized with a size prefix. */
+		uint8 bRaw = 0;
+
+		int64 DataOffset = 0;
+		int64 DataSize = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FColumnSchema& Schema)
+		{
+			Ar << Schema.VarName << Schema.PropertyType << Schema.ValueSize << Schema.bRaw << Schema.DataOffset << Schema.DataSize;
+			return Ar;
+		}
+	};
+
+	bool IsRawProperty(const UProperty* Property)
+	{
+		// Only numbers, bytes and enums mean the same in another session. Other plain old data (object pointers, names, weak pointers)
+		// only means something in this process, and bitfield bools share their byte with other flags, so they all go through the property.
+		return FPSPropertyCache::GetNumericKind(Property) != EPSNumericKind::None;
+	}
+
+	bool MatchesSchema(const UProperty* Property, const FColumnSchema& Schema)
+	{
+		return Property
+			&& Property->GetSize() == Schema.ValueSize
+			&& IsRawProperty(Property) == (Schema.bRaw != 0)
+			&& Property->GetCPPType() == Schema.PropertyType;
+	}
+
+	// Resolves VarName for each target, one lookup per class run
+	void ResolveProperties(const TArray<UObject*>& Targets, FName VarName, TArray<UProperty*>& OutProperties)
+	{
+		OutProperties.SetNumUninitialized(Targets.Num());
+
+		const UClass* LastClass = nullptr;
+		UProperty* LastProperty = nullptr;
+		for (int32 Index = 0; Index < Targets.Num(); ++Index)
+		{
+			if (Targets[Index] && Targets[Index]->GetClass() != LastClass)
+			{
+				LastClass = Targets[Index]->GetClass();
+				LastProperty = FPSPropertyCache::FindProperty(LastClass, VarName);
+			}
+
+			OutProperties[Index] = Targets[Index] ? LastProperty : nullptr;
+		}
+	}
+
+	void SerializeValue(FArchive& Ar, const UProperty* Property, void* Value)
+	{
+		FStructuredArchiveFromArchive StructuredAr(Ar);
+		for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex)
+		{
+			Property->SerializeItem(StructuredAr.GetSlot(), (uint8*)Value + ArrayIndex * Property->ElementSize);
+		}
+	}
+}
+
+bool FPSColumnFile::Save(const FString& Filename, const TArray<UObject*>& Targets, const TArray<FName>& VarNames)
+{
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!FileWriter)
+	{
+		return false;
+	}
+
+	FArchive& Ar = *FileWriter;
+
+	uint32 Magic = ColumnFileMagic;
+	int32 Version = ColumnFileVersion;
+	int32 NumObjects = Targets.Num();
+	int32 NumColumns = VarNames.Num();
+	Ar << Magic << Version << NumObjects << NumColumns;
+
+	// Each column takes its type from the first target that has the variable, targets whose class disagrees are stored as absent
+	TArray<FColumnSchema> Schemas;
+	TArray<TArray<UProperty*>> ColumnProperties;
+	Schemas.SetNum(NumColumns);
+	ColumnProperties.SetNum(NumColumns);
+
+	for (int32 ColumnIndex = 0; ColumnIndex < NumColumns; ++ColumnIndex)
+	{
+		FColumnSchema& Schema = Schemas[ColumnIndex];
+		Schema.VarName = VarNames[ColumnIndex].ToString();
+
+		TArray<UProperty*>& Properties = ColumnProperties[ColumnIndex];
+		ResolveProperties(Targets, VarNames[ColumnIndex], Properties);
+
+		for (const UProperty* Property : Properties)
+		{
+			if (Property)
+			{
+				Schema.PropertyType = Property->GetCPPType();
+				Schema.ValueSize = Property->GetSize();
+				Schema.bRaw = IsRawProperty(Property) ? 1 : 0;
+				break;
+			}
+		}
+	}
+
+	// Offsets aren't known yet, the schema is written again once the columns are in. Its size doesn't change.
+	const int64 SchemaOffset = Ar.Tell();
+	for (FColumnSchema& Schema : Schemas)
+	{
+		Ar << Schema;
+	}
+
+	TArray<uint8> Chunk;
+	Chunk.Reserve(WriteChunkSize * 2);
+
+	for (int32 ColumnIndex = 0; ColumnIndex < NumColumns; ++ColumnIndex)
+	{
+		FColumnSchema& Schema = Schemas[ColumnIndex];
+		const TArray<UProperty*>& Properties = ColumnProperties[ColumnIndex];
+		Schema.DataOffset = Ar.Tell();
+
+		TArray<uint8> PresenceMask;
+		PresenceMask.SetNumZeroed((NumObjects + 7) / 8);
+		for (int32 Index = 0; Index < NumObjects; ++Index)
+		{
+			if (MatchesSchema(Properties[Index], Schema))
+			{
+				PresenceMask[Index / 8] |= 1 << (Index % 8);
+			}
+		}
+		Ar.Serialize(PresenceMask.GetData(), PresenceMask.Num());
+
+		for (int32 Index = 0; Index < NumObjects; ++Index)
+		{
+			const bool bPresent = (PresenceMask[Index / 8] & (1 << (Index % 8))) != 0;
+
+			if (Schema.bRaw)
+			{
+				// Fixed stride, absent values are zero filled so loading can index straight into the column
+				const int32 ChunkOffset = Chunk.AddZeroed(Schema.ValueSize);
+				if (bPresent)
+				{
+					FMemory::Memcpy(Chunk.GetData() + ChunkOffset, Properties[Index]->ContainerPtrToValuePtr<void>(Targets[Index]), Schema.ValueSize);
+				}
+			}
+			else if (bPresent)
+			{
+				// Size prefixed, so loading can skip values whose class doesn't match without knowing how to read them
+				const int32 SizeOffset = Chunk.AddZeroed(sizeof(int32));
+
+				FMemoryWriter ChunkWriter(Chunk);
+				ChunkWriter.Seek(Chunk.Num());
+				FObjectAndNameAsStringProxyArchive ValueWriter(ChunkWriter, false);
+				SerializeValue(ValueWriter, Properties[Index], Properties[Index]->ContainerPtrToValuePtr<void>(Targets[Index]));
+
+				const int32 ValueSize = Chunk.Num() - SizeOffset - sizeof(int32);
+				FMemory::Memcpy(Chunk.GetData() + SizeOffset, &ValueSize, sizeof(int32));
+			}
+
+			if (Chunk.Num() >= WriteChunkSize)
+			{
+				Ar.Serialize(Chunk.GetData(), Chunk.Num());
+				Chunk.Reset();
+			}
+		}
+
+		if (Chunk.Num() > 0)
+		{
+			Ar.Serialize(Chunk.GetData(), Chunk.Num());
+			Chunk.Reset();
+		}
+
+		Schema.DataSize = Ar.Tell() - Schema.DataOffset;
+	}
+
+	const int64 EndOffset = Ar.Tell();
+	Ar.Seek(SchemaOffset);
+	for (FColumnSchema& Schema : Schemas)
+	{
+		Ar << Schema;
+	}
+	Ar.Seek(EndOffset);
+
+	const bool bError = Ar.IsError();
+	return FileWriter->Close() && !bError;
+}
+
+bool FPSColumnFile::Load(const FString& Filename, const TArray<UObject*>& Targets, TArray<FString>& OutErrors)
+{
+	// Map the file where the platform supports it, otherwise read it in one go. The region has to go before the handle.
+	TUniquePtr<IMappedFileHandle> MappedHandle(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> FallbackData;
+
+	const uint8* FileData = nullptr;
+	int64 FileSize = 0;
+
+	if (MappedHandle)
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion());
+		if (MappedRegion)
+		{
+			FileData = MappedRegion->GetMappedPtr();
+			FileSize = MappedRegion->GetMappedSize();
+		}
+	}
+
+	if (!FileData)
+	{
+		if (!FFileHelper::LoadFileToArray(FallbackData, *Filename))
+		{
+			OutErrors.Add(FString::Printf(TEXT("Could not read %s"), *Filename));
+			return false;
+		}
+
+		FileData = FallbackData.GetData();
+		FileSize = FallbackData.Num();
+	}
+
+	FBufferReader HeaderReader((void*)FileData, FileSize, false);
+
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 NumObjects = 0;
+	int32 NumColumns = 0;
+	HeaderReader << Magic << Version << NumObjects << NumColumns;
+
+	if (HeaderReader.IsError() || Magic != ColumnFileMagic || Version != ColumnFileVersion)
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s is not a population column file this version can read"), *Filename));
+		return false;
+	}
+
+	if (NumObjects != Targets.Num())
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s holds %d objects but %d targets were given"), *Filename, NumObjects, Targets.Num()));
+		return false;
+	}
+
+	TArray<FColumnSchema> Schemas;
+	Schemas.SetNum(NumColumns);
+	for (FColumnSchema& Schema : Schemas)
+	{
+		HeaderReader << Schema;
+	}
+
+	if (HeaderReader.IsError())
+	{
+		OutErrors.Add(FString::Printf(TEXT("%s has a truncated schema"), *Filename));
+		return false;
+	}
+
+	const int32 PresenceMaskSize = (NumObjects + 7) / 8;
+	TArray<UProperty*> Properties;
+
+	// Loads count as setter writes: journaled when the journal is on, and reported when the variable is observed
+	const bool bJournaled = FPSJournal::IsEnabled();
+
+	for (const FColumnSchema& Schema : Schemas)
+	{
+		if (Schema.DataOffset < 0 || Schema.DataSize < PresenceMaskSize || Schema.DataOffset + Schema.DataSize > FileSize)
+		{
+			OutErrors.Add(FString::Printf(TEXT("Column %s is out of the file's bounds, skipped"), *Schema.VarName));
+			continue;
+		}
+
+		const uint8* ColumnData = FileData + Schema.DataOffset;
+		const uint8* PresenceMask = ColumnData;
+		const uint8* Values = ColumnData + PresenceMaskSize;
+		const int64 ValuesSize = Schema.DataSize - PresenceMaskSize;
+
+		if (Schema.bRaw && ValuesSize < (int64)NumObjects * Schema.ValueSize)
+		{
+			OutErrors.Add(FString::Printf(TEXT("Column %s is truncated, skipped"), *Schema.VarName));
+			continue;
+		}
+
+		const FName VarName(*Schema.VarName);
+		ResolveProperties(Targets, VarName, Properties);
+		const bool bObserved = FPSPropertyCache::IsObserved(VarName);
+
+		// Check the schema once per class instead of once per value
+		const UClass* LastClass = nullptr;
+		bool bLastClassMatches = false;
+		TSet<const UClass*> ReportedClasses;
+
+		FBufferReader ValueReader((void*)Values, ValuesSize, false);
+		FObjectAndNameAsStringProxyArchive ProxyReader(ValueReader, false);
+
+		for (int32 Index = 0; Index < NumObjects; ++Index)
+		{
+			const bool bPresent = (PresenceMask[Index / 8] & (1 << (Index % 8))) != 0;
+			UObject* Target = Targets[Index];
+
+			if (Target && Target->GetClass() != LastClass)
+			{
+				LastClass = Target->GetClass();
+				bLastClassMatches = MatchesSchema(Properties[Index], Schema);
+
+				if (!bLastClassMatches && !ReportedClasses.Contains(LastClass))
+				{
+					ReportedClasses.Add(LastClass);
+					OutErrors.Add(FString::Printf(TEXT("Column %s (%s) doesn't match a variable on %s, skipped for that class"), *Schema.VarName, *Schema.PropertyType, *LastClass->GetName()));
+				}
+			}
+
+			const bool bApply = bPresent && Target && bLastClassMatches;
+
+			if (Schema.bRaw)
+			{
+				if (bApply)
+				{
+					FPSObservedWrite ObservedWrite(Target, Properties[Index], bObserved, bJournaled);
+					FMemory::Memcpy(Properties[Index]->ContainerPtrToValuePtr<void>(Target), Values + (int64)Index * Schema.ValueSize, Schema.ValueSize);
+				}
+			}
+			else if (bPresent)
+			{
+				int32 ValueSize = 0;
+				ValueReader << ValueSize;
+
+				const int64 ValueEnd = ValueReader.Tell() + ValueSize;
+				if (ValueReader.IsError() || ValueSize < 0 || ValueEnd > ValuesSize)
+				{
+					OutErrors.Add(FString::Printf(TEXT("Column %s is truncated, stopped at object %d"), *Schema.VarName, Index));
+					break;
+				}
+
+				if (bApply)
+				{
+					FPSObservedWrite ObservedWrite(Target, Properties[Index], bObserved, bJournaled);
+					SerializeValue(ProxyReader, Properties[Index], Properties[Index]->ContainerPtrToValuePtr<void>(Target));
+				}
+
+				ValueReader.Seek(ValueEnd);
+			}
+		}
+	}
+
+	return true;
+}
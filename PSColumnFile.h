@@ -0,0 +1,31 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Columnar binary save/load of named variables for a whole population.
+ *
+ * The file starts with a schema (one entry per variable: name, property type, element size, where its column lives),
+ * followed by one column per variable. Numeric (and enum) columns are the raw values back to back, other columns are each value
+ * serialized in turn, with objects and names written as strings. Every column starts with a presence bitmask so objects that lack the variable round trip.
+ *
+ * Saving streams column by column. Loading memory maps the file and applies whole columns at a time, checking each column
+ * against the live class once instead of once per value. Loaded values count as setter writes: they are recorded to FPSJournal
+ * while it is enabled and reported to FPSPropertyObservers when observed. Either one costs a copy of the old value per write,
+ * columns nobody journals or observes are copied straight in.
+ */
+struct NFPOPULATIONSYSTEM_API FPSColumnFile
+{
+	/** Writes VarNames of every one of Targets to Filename. */
+	static bool Save(const FString& Filename, const TArray<UObject*>& Targets, const TArray<FName>& VarNames);
+
+	/**
+	 * Applies the columns in Filename to Targets, which must be the same population (same count and order) the file was saved from.
+	 * Columns that don't match a target's class (renamed, removed or retyped variables) are skipped, with one message per column and class in OutErrors.
+	 *
+	 * @return	False if the file could not be read at all.
+	 */
+	static bool Load(const FString& Filename, const TArray<UObject*>& Targets, TArray<FString>& OutErrors);
+};
@@ -0,0 +1,193 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSColumnStore.h"
+
+#include "PSPropertyCache.h"
+#include "Tickable.h"
+
+namespace
+{
+	// Pushes every column that asked for it once per tick
+	class FPSColumnTicker : public FTickableGameObject
+	{
+	public:
+
+		static FPSColumnTicker& Get()
+		{
+			static FPSColumnTicker Ticker;
+			return Ticker;
+		}
+
+		void Register(FPSColumnBase* Column)
+		{
+			Columns.AddUnique(Column);
+		}
+
+		void Unregister(FPSColumnBase* Column)
+		{
+			Columns.RemoveSingle(Column);
+		}
+
+		virtual void Tick(float DeltaTime) override
+		{
+			for (FPSColumnBase* Column : Columns)
+			{
+				Column->Push();
+			}
+		}
+
+		virtual bool IsTickable() const override
+		{
+			return Columns.Num() > 0;
+		}
+
+		virtual TStatId GetStatId() const override
+		{
+			RETURN_QUICK_DECLARE_CYCLE_STAT(FPSColumnTicker, STATGROUP_Tickables);
+		}
+
+	private:
+
+		TArray<FPSColumnBase*> Columns;
+	};
+}
+
+FPSColumnBase::FPSColumnBase(FName InVarName)
+	: VarName(InVarName)
+	, AddressGeneration(FPSPropertyCache::GetGeneration())
+	, bSyncOnTick(false)
+{
+}
+
+FPSColumnBase::~FPSColumnBase()
+{
+	SetSyncOnTick(false);
+}
+
+void FPSColumnBase::SetClassFilter(const TArray<UClass*>& InClasses)
+{
+	ClassFilter = InClasses;
+}
+
+int32 FPSColumnBase::AddObjects(const TArray<UObject*>& InObjects)
+{
+	RefreshAddresses();
+
+	const int32 FirstNewRow = Objects.Num();
+	Objects.Reserve(FirstNewRow + InObjects.Num());
+	Addresses.Reserve(FirstNewRow + InObjects.Num());
+
+	for (UObject* Object : InObjects)
+	{
+		if (void* Address = ResolveAddress(Object))
+		{
+			Objects.Add(Object);
+			Addresses.Add(Address);
+		}
+	}
+
+	SetNumValues(Objects.Num());
+
+	// Only the new rows, existing rows may hold edits that haven't been pushed yet
+	PullRows(FirstNewRow, Objects.Num());
+
+	return Objects.Num() - FirstNewRow;
+}
+
+void FPSColumnBase::RemoveStaleRows()
+{
+	int32 WriteRow = 0;
+	for (int32 ReadRow = 0; ReadRow < Objects.Num(); ++ReadRow)
+	{
+		if (Objects[ReadRow].IsValid())
+		{
+			if (WriteRow != ReadRow)
+			{
+				Objects[WriteRow] = Objects[ReadRow];
+				Addresses[WriteRow] = Addresses[ReadRow];
+				MoveValue(ReadRow, WriteRow);
+			}
+			++WriteRow;
+		}
+	}
+
+	Objects.SetNum(WriteRow, false);
+	Addresses.SetNum(WriteRow, false);
+	SetNumValues(WriteRow);
+}
+
+void FPSColumnBase::Reset()
+{
+	Objects.Reset();
+	Addresses.Reset();
+	SetNumValues(0);
+}
+
+void FPSColumnBase::SetSyncOnTick(bool bInSyncOnTick)
+{
+	if (bSyncOnTick == bInSyncOnTick)
+	{
+		return;
+	}
+
+	bSyncOnTick = bInSyncOnTick;
+	if (bSyncOnTick)
+	{
+		FPSColumnTicker::Get().Register(this);
+	}
+	else
+	{
+		FPSColumnTicker::Get().Unregister(this);
+	}
+}
+
+void FPSColumnBase::RefreshAddresses()
+{
+	const uint32 CurrentGeneration = FPSPropertyCache::GetGeneration();
+	if (AddressGeneration == CurrentGeneration)
+	{
+		return;
+	}
+
+	AddressGeneration = CurrentGeneration;
+	for (int32 Row = 0; Row < Objects.Num(); ++Row)
+	{
+		Addresses[Row] = ResolveAddress(Objects[Row].Get());
+	}
+}
+
+void* FPSColumnBase::ResolveAddress(UObject* Object) const
+{
+	if (!Object)
+	{
+		return nullptr;
+	}
+
+	UClass* Class = Object->GetClass();
+	if (ClassFilter.Num() > 0)
+	{
+		bool bPassesFilter = false;
+		for (const UClass* FilterClass : ClassFilter)
+		{
+			if (Class->IsChildOf(FilterClass))
+			{
+				bPassesFilter = true;
+				break;
+			}
+		}
+
+		if (!bPassesFilter)
+		{
+			return nullptr;
+		}
+	}
+
+	UProperty* Property = FPSPropertyCache::FindProperty(Class, VarName);
+	if (!Property || !IsSupportedProperty(Property))
+	{
+		return nullptr;
+	}
+
+	return Property->ContainerPtrToValuePtr<void>(Object);
+}
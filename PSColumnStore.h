@@ -0,0 +1,149 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UnrealType.h"
+#include "UObject/WeakObjectPtr.h"
+
+/**
+ * Structure-of-arrays mirror of one named property across a population of objects.
+ * Values live in one contiguous, 16 byte aligned array so hot loops can run over them directly,
+ * then get synced back to the objects in one batch (explicitly with Push(), or every tick).
+ */
+class NFPOPULATIONSYSTEM_API FPSColumnBase
+{
+public:
+
+	explicit FPSColumnBase(FName InVarName);
+	virtual ~FPSColumnBase();
+
+	/** Only objects of these classes (or their children) are accepted. Empty accepts any class that has the property. */
+	void SetClassFilter(const TArray<UClass*>& InClasses);
+
+	/** Adds the objects that pass the class filter and have a matching property, and pulls their current values. Returns how many were added. */
+	int32 AddObjects(const TArray<UObject*>& InObjects);
+
+	/** Drops rows whose object has been destroyed. Keeps the order of the remaining rows. */
+	void RemoveStaleRows();
+
+	void Reset();
+
+	int32 Num() const { return Objects.Num(); }
+	FName GetVarName() const { return VarName; }
+	UObject* GetObject(int32 Row) const { return Objects[Row].Get(); }
+
+	/** Copies the current values from the objects into the column. */
+	virtual void Pull() = 0;
+
+	/** Writes the column back to the objects. */
+	virtual void Push() = 0;
+
+	/** When set, the column is pushed back to its objects at the end of every tick. */
+	void SetSyncOnTick(bool bInSyncOnTick);
+	bool GetSyncOnTick() const { return bSyncOnTick; }
+
+protected:
+
+	virtual bool IsSupportedProperty(const UProperty* Property) const = 0;
+
+	/** Copies the values of rows [FirstRow, EndRow) from their objects. */
+	virtual void PullRows(int32 FirstRow, int32 EndRow) = 0;
+	virtual void SetNumValues(int32 NewNum) = 0;
+	virtual void MoveValue(int32 FromRow, int32 ToRow) = 0;
+
+	/** Re-resolves the value addresses if the property cache was invalidated (classes got reinstanced) since they were resolved. */
+	void RefreshAddresses();
+
+	FName VarName;
+	TArray<UClass*> ClassFilter;
+
+	TArray<TWeakObjectPtr<UObject>> Objects;
+
+	/** Address of the property value inside each object, nullptr if it could not be resolved. */
+	TArray<void*> Addresses;
+
+private:
+
+	void* ResolveAddress(UObject* Object) const;
+
+	uint32 AddressGeneration;
+	bool bSyncOnTick;
+};
+
+/**
+ * Typed column. ValueType must be the C++ type PropertyType stores (float for UFloatProperty, etc).
+ */
+template<typename ValueType, typename PropertyType>
+class TPSColumn : public FPSColumnBase
+{
+public:
+
+	explicit TPSColumn(FName InVarName)
+		: FPSColumnBase(InVarName)
+	{
+	}
+
+	ValueType* GetData() { return Values.GetData(); }
+	const ValueType* GetData() const { return Values.GetData(); }
+
+	ValueType& operator[](int32 Row) { return Values[Row]; }
+	const ValueType& operator[](int32 Row) const { return Values[Row]; }
+
+	virtual void Pull() override
+	{
+		RefreshAddresses();
+		PullRows(0, Values.Num());
+	}
+
+	virtual void Push() override
+	{
+		RefreshAddresses();
+
+		for (int32 Row = 0; Row < Values.Num(); ++Row)
+		{
+			if (Addresses[Row] && Objects[Row].IsValid())
+			{
+				*static_cast<ValueType*>(Addresses[Row]) = Values[Row];
+			}
+		}
+	}
+
+protected:
+
+	virtual bool IsSupportedProperty(const UProperty* Property) const override
+	{
+		return Property->IsA<PropertyType>() && Property->ArrayDim == 1 && Property->ElementSize == sizeof(ValueType);
+	}
+
+	virtual void PullRows(int32 FirstRow, int32 EndRow) override
+	{
+		for (int32 Row = FirstRow; Row < EndRow; ++Row)
+		{
+			if (Addresses[Row] && Objects[Row].IsValid())
+			{
+				Values[Row] = *static_cast<const ValueType*>(Addresses[Row]);
+			}
+		}
+	}
+
+	virtual void SetNumValues(int32 NewNum) override
+	{
+		Values.SetNumZeroed(NewNum);
+	}
+
+	virtual void MoveValue(int32 FromRow, int32 ToRow) override
+	{
+		Values[ToRow] = Values[FromRow];
+	}
+
+private:
+
+	TArray<ValueType, TAlignedHeapAllocator<16>> Values;
+};
+
+typedef TPSColumn<float, UFloatProperty> FPSFloatColumn;
+typedef TPSColumn<double, UDoubleProperty> FPSDoubleColumn;
+typedef TPSColumn<int32, UIntProperty> FPSIntColumn;
+typedef TPSColumn<int64, UInt64Property> FPSInt64Column;
+typedef TPSColumn<uint8, UByteProperty> FPSByteColumn;
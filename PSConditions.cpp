@@ -0,0 +1,188 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSConditions.h"
+
+#include "PSPropertyCache.h"
+#include "Tickable.h"
+
+namespace
+{
+	struct FPSPendingCondition
+	{
+		FWeakObjectPtr Target;
+		double Operand;
+		EPSCompareOp Op;
+		TSharedRef<FPSConditionSignal> Signal;
+	};
+
+	/** Every condition on one variable of one class */
+	struct FPSConditionGroup
+	{
+		FWeakObjectPtr Class;
+		FName VarName;
+		FPSNumericAccess Numeric;
+
+		/** FPSPropertyCache generation Numeric was resolved in */
+		uint32 Generation;
+
+		TArray<FPSPendingCondition> Conditions;
+	};
+
+	FORCEINLINE bool IsMet(double Value, EPSCompareOp Op, double Operand)
+	{
+		switch (Op)
+		{
+		case EPSCompareOp::Less:			return Value < Operand;
+		case EPSCompareOp::LessOrEqual:		return Value <= Operand;
+		case EPSCompareOp::Greater:			return Value > Operand;
+		case EPSCompareOp::GreaterOrEqual:	return Value >= Operand;
+		case EPSCompareOp::Equal:			return Value == Operand;
+		case EPSCompareOp::NotEqual:		return Value != Operand;
+		default:							return false;
+		}
+	}
+
+	// Checks every pending condition once per tick
+	class FPSConditionTicker : public FTickableGameObject
+	{
+	public:
+
+		static FPSConditionTicker& Get()
+		{
+			static FPSConditionTicker Ticker;
+			return Ticker;
+		}
+
+		void Add(const UClass* Class, FName VarName, const FPSNumericAccess& Numeric, FPSPendingCondition&& Condition)
+		{
+			FPSConditionGroup* Group = Groups.Find(TPair<const UClass*, FName>(Class, VarName));
+			if (!Group)
+			{
+				Group = &Groups.Add(TPair<const UClass*, FName>(Class, VarName));
+				Group->Class = const_cast<UClass*>(Class);
+				Group->VarName = VarName;
+				Group->Numeric = Numeric;
+				Group->Generation = FPSPropertyCache::GetGeneration();
+			}
+			Group->Conditions.Add(MoveTemp(Condition));
+			++NumPending;
+		}
+
+		int32 GetNumPending() const
+		{
+			return NumPending;
+		}
+
+		virtual void Tick(float DeltaTime) override
+		{
+			const uint32 Generation = FPSPropertyCache::GetGeneration();
+
+			for (auto It = Groups.CreateIterator(); It; ++It)
+			{
+				FPSConditionGroup& Group = It.Value();
+				TArray<FPSPendingCondition>& Conditions = Group.Conditions;
+
+				// Reinstancing may have moved the variable (or removed it)
+				if (Group.Generation != Generation)
+				{
+					Group.Generation = Generation;
+					const UClass* Class = Cast<UClass>(Group.Class.Get());
+					if (!Class || !FPSPropertyCache::FindNumeric(Class, Group.VarName, Group.Numeric))
+					{
+						for (FPSPendingCondition& Condition : Conditions)
+						{
+							Condition.Signal->bAbandoned = true;
+						}
+						NumPending -= Conditions.Num();
+						It.RemoveCurrent();
+						continue;
+					}
+				}
+
+				// One pass over the group, keeping the conditions that still wait at the front
+				const FPSNumericAccess Numeric = Group.Numeric;
+				int32 NumKept = 0;
+				for (int32 Index = 0; Index < Conditions.Num(); ++Index)
+				{
+					FPSPendingCondition& Condition = Conditions[Index];
+					if (Condition.Signal.IsUnique())
+					{
+						// Nobody waits for it anymore
+						continue;
+					}
+
+					const UObject* Target = Condition.Target.Get();
+					if (!Target)
+					{
+						Condition.Signal->bAbandoned = true;
+						continue;
+					}
+
+					if (IsMet(Numeric.Read<double>(Target), Condition.Op, Condition.Operand))
+					{
+						Condition.Signal->bFired = true;
+						continue;
+					}
+
+					if (NumKept != Index)
+					{
+						Conditions[NumKept] = Condition;
+					}
+					++NumKept;
+				}
+
+				NumPending -= Conditions.Num() - NumKept;
+				Conditions.RemoveAt(NumKept, Conditions.Num() - NumKept, false);
+				if (NumKept == 0)
+				{
+					It.RemoveCurrent();
+				}
+			}
+		}
+
+		virtual bool IsTickable() const override
+		{
+			return NumPending > 0;
+		}
+
+		virtual TStatId GetStatId() const override
+		{
+			RETURN_QUICK_DECLARE_CYCLE_STAT(FPSConditionTicker, STATGROUP_Tickables);
+		}
+
+	private:
+
+		TMap<TPair<const UClass*, FName>, FPSConditionGroup> Groups;
+		int32 NumPending = 0;
+	};
+}
+
+TSharedRef<FPSConditionSignal> FPSConditions::WaitFor(UObject* Target, FName VarName, EPSCompareOp Op, double Operand)
+{
+	check(IsInGameThread());
+
+	TSharedRef<FPSConditionSignal> Signal = MakeShared<FPSConditionSignal>();
+
+	FPSNumericAccess Numeric;
+	if (!Target || !FPSPropertyCache::FindNumeric(Target->GetClass(), VarName, Numeric))
+	{
+		Signal->bAbandoned = true;
+		return Signal;
+	}
+
+	// Already met, no need to wait for the next tick
+	if (IsMet(Numeric.Read<double>(Target), Op, Operand))
+	{
+		Signal->bFired = true;
+		return Signal;
+	}
+
+	FPSConditionTicker::Get().Add(Target->GetClass(), VarName, Numeric, FPSPendingCondition{ Target, Operand, Op, Signal });
+	return Signal;
+}
+
+int32 FPSConditions::GetNumPending()
+{
+	return FPSConditionTicker::Get().GetNumPending();
+}
@@ -0,0 +1,69 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LatentActions.h"
+#include "Engine/LatentActionManager.h"
+#include "PSTypes.h"
+
+/** Shared between a waiter and FPSConditions. The waiter cancels by dropping its reference. */
+struct FPSConditionSignal
+{
+	/** The condition was met */
+	bool bFired = false;
+
+	/** The condition can no longer be checked (target destroyed, variable gone or not a number) */
+	bool bAbandoned = false;
+};
+
+/**
+ * Central list of "wait until Target.VarName Op Operand" conditions, so thousands of waits don't each poll on their own.
+ *
+ * Conditions are grouped by class and variable. Once per tick each group resolves the variable's offset (only again after classes
+ * are reinstanced) and checks all its conditions in one pass, reading each target's value straight from memory. Met conditions
+ * are signalled and dropped, the rest wait for the next tick. Works for float, double, int, byte and enum variables. Game thread only.
+ */
+struct NFPOPULATIONSYSTEM_API FPSConditions
+{
+	/** Starts waiting. A condition that is already met, or can't be checked, is signalled before this returns. */
+	static TSharedRef<FPSConditionSignal> WaitFor(UObject* Target, FName VarName, EPSCompareOp Op, double Operand);
+
+	/** Conditions still waiting, for stats. */
+	static int32 GetNumPending();
+};
+
+/** Latent action behind UPSData::WaitUntilValueByName. Resumes once its condition fires, ends silently if it is abandoned. */
+class FPSWaitForConditionAction : public FPendingLatentAction
+{
+public:
+
+	FPSWaitForConditionAction(const FLatentActionInfo& LatentInfo, const TSharedRef<FPSConditionSignal>& InSignal)
+		: ExecutionFunction(LatentInfo.ExecutionFunction)
+		, OutputLink(LatentInfo.Linkage)
+		, CallbackTarget(LatentInfo.CallbackTarget)
+		, Signal(InSignal)
+	{
+	}
+
+	virtual void UpdateOperation(FLatentResponse& Response) override
+	{
+		// Nothing to check here, FPSConditions did it for every waiting action at once
+		Response.FinishAndTriggerIf(Signal->bFired, ExecutionFunction, OutputLink, CallbackTarget);
+		Response.DoneIf(Signal->bAbandoned);
+	}
+
+#if WITH_EDITOR
+	virtual FString GetDescription() const override
+	{
+		return Signal->bFired ? TEXT("Condition met") : TEXT("Waiting for condition");
+	}
+#endif
+
+private:
+
+	FName ExecutionFunction;
+	int32 OutputLink;
+	FWeakObjectPtr CallbackTarget;
+	TSharedRef<FPSConditionSignal> Signal;
+};
@@ -2,6 +2,361 @@
 
 
 #include "PSData.h"
+#include "PSBulkOps.h"
+#include "PSConditions.h"
+#include "PSJournal.h"
+#include "PSLayoutSchema.h"
+#include "PSObservers.h"
+#include "PSPropertyCache.h"
+
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Templates/UniquePtr.h"
+
+namespace
+{
+	// Gathers the resolved values into a dense buffer, runs Kernel over it, then scatters the results back
+	template<typename ValueType, typename KernelType>
+	int32 ApplyBulkKernel(const TArray<UObject*>& Targets, FName VarName, const UClass* PropertyClass, KernelType Kernel)
+	{
+		TArray<void*> Addresses;
+		const int32 NumResolved = FPSPropertyCache::ResolveValueAddresses(Targets, VarName, PropertyClass, Addresses);
+		if (NumResolved == 0)
+		{
+			return 0;
+		}
+
+		TArray<ValueType, TAlignedHeapAllocator<16>> Values;
+		Values.Reserve(NumResolved);
+		for (void* Address : Addresses)
+		{
+			if (Address)
+			{
+				Values.Add(*static_cast<const ValueType*>(Address));
+			}
+		}
+
+		if (!Kernel(Values.GetData(), Values.Num()))
+		{
+			return 0;
+		}
+
+		int32 ValueIndex = 0;
+		for (void* Address : Addresses)
+		{
+			if (Address)
+			{
+				*static_cast<ValueType*>(Address) = Values[ValueIndex++];
+			}
+		}
+
+		return NumResolved;
+	}
+
+	// Queries are split into chunks of this many targets, and only go wide once there are enough chunks to be worth it
+	const int32 QueryChunkSize = 2048;
+	const int32 ParallelQueryThreshold = QueryChunkSize * 8;
+
+	template<typename ValueType>
+	void QueryIndices(const TArray<UObject*>& Targets, FName VarName, const UClass* PropertyClass, EPSCompareOp Op, ValueType Operand, TArray<int32>& OutIndices)
+	{
+		OutIndices.Reset();
+
+		// Resolving goes through the property cache, so it stays on the calling thread
+		TArray<void*> Addresses;
+		if (FPSPropertyCache::ResolveValueAddresses(Targets, VarName, PropertyClass, Addresses) == 0)
+		{
+			return;
+		}
+
+		const int32 NumChunks = FMath::DivideAndRoundUp(Targets.Num(), QueryChunkSize);
+		TArray<TArray<int32>> ChunkMatches;
+		ChunkMatches.SetNum(NumChunks);
+
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+		{
+			const int32 FirstIndex = ChunkIndex * QueryChunkSize;
+			const int32 LastIndex = FMath::Min(FirstIndex + QueryChunkSize, Targets.Num());
+
+			TArray<ValueType, TInlineAllocator<QueryChunkSize>> Values;
+			TArray<int32, TInlineAllocator<QueryChunkSize>> SourceIndices;
+			for (int32 Index = FirstIndex; Index < LastIndex; ++Index)
+			{
+				if (const void* Address = Addresses[Index])
+				{
+					Values.Add(*static_cast<const ValueType*>(Address));
+					SourceIndices.Add(Index);
+				}
+			}
+
+			TArray<int32>& Matches = ChunkMatches[ChunkIndex];
+			FPSBulkOps::Compare(Values.GetData(), Values.Num(), Op, Operand, Matches);
+			for (int32& Match : Matches)
+			{
+				Match = SourceIndices[Match];
+			}
+		}, Targets.Num() < ParallelQueryThreshold);
+
+		for (TArray<int32>& Matches : ChunkMatches)
+		{
+			OutIndices.Append(Matches);
+		}
+	}
+
+	// Below this many keys a comparison sort beats the fixed cost of the radix histograms
+	const int32 RadixSortThreshold = 64;
+
+	/**
+	 * Reads the numeric variable (float, double, any int, byte or enum) named VarName from each target as a double, resolving it once per class run.
+	 * OutIndices gets the index of the target each value came from, OutMissing (if given) the targets that don't have the variable.
+	 */
+	void GatherNumericValues(const TArray<UObject*>& Targets, FName VarName, TArray<double>& OutValues, TArray<int32>& OutIndices, TArray<int32>* OutMissing = nullptr)
+	{
+		OutValues.Reset(Targets.Num());
+		OutIndices.Reset(Targets.Num());
+
+		const UClass* LastClass = nullptr;
+		FPSNumericAccess LastAccess;
+		bool bLastFound = false;
+
+		for (int32 Index = 0; Index < Targets.Num(); ++Index)
+		{
+			UObject* Target = Targets[Index];
+			if (Target && Target->GetClass() != LastClass)
+			{
+				LastClass = Target->GetClass();
+				bLastFound = FPSPropertyCache::FindNumeric(LastClass, VarName, LastAccess);
+			}
+
+			if (!Target || !bLastFound)
+			{
+				if (OutMissing)
+				{
+					OutMissing->Add(Index);
+				}
+				continue;
+			}
+
+			OutValues.Add(LastAccess.Read<double>(Target));
+			OutIndices.Add(Index);
+		}
+	}
+
+	/**
+	 * Sort keys, compared as unsigned ints, for the numeric variable named VarName on each target. Ints are keyed exactly: signed ones with
+	 * the sign bit flipped, unsigned ones as they are. Float and double are keyed through their bits, and so are ints sorted together with
+	 * them, or uint64 sorted together with signed ints, as those have no common integer key. Indices and missing targets as GatherNumericValues.
+	 */
+	void GatherSortKeys(const TArray<UObject*>& Targets, FName VarName, TArray<uint64>& OutKeys, TArray<int32>& OutIndices, TArray<int32>& OutMissing)
+	{
+		OutKeys.Reset(Targets.Num());
+		OutIndices.Reset(Targets.Num());
+
+		TArray<FPSNumericAccess> Accesses;
+		Accesses.Reserve(Targets.Num());
+		bool bAnyFloat = false;
+		bool bAnySigned = false;
+		bool bAnyUInt64 = false;
+
+		const UClass* LastClass = nullptr;
+		FPSNumericAccess LastAccess;
+		bool bLastFound = false;
+
+		for (int32 Index = 0; Index < Targets.Num(); ++Index)
+		{
+			UObject* Target = Targets[Index];
+			if (Target && Target->GetClass() != LastClass)
+			{
+				LastClass = Target->GetClass();
+				bLastFound = FPSPropertyCache::FindNumeric(LastClass, VarName, LastAccess);
+				if (bLastFound)
+				{
+					switch (LastAccess.Kind)
+					{
+					case EPSNumericKind::Float:
+					case EPSNumericKind::Double:	bAnyFloat = true; break;
+					case EPSNumericKind::Int8:
+					case EPSNumericKind::Int16:
+					case EPSNumericKind::Int32:
+					case EPSNumericKind::Int64:		bAnySigned = true; break;
+					case EPSNumericKind::UInt64:	bAnyUInt64 = true; break;
+					default:						break;
+					}
+				}
+			}
+
+			if (!Target || !bLastFound)
+			{
+				OutMissing.Add(Index);
+				continue;
+			}
+
+			Accesses.Add(LastAccess);
+			OutIndices.Add(Index);
+		}
+
+		const bool bDoubleKeys = bAnyFloat || (bAnySigned && bAnyUInt64);
+		for (int32 Index = 0; Index < OutIndices.Num(); ++Index)
+		{
+			const UObject* Target = Targets[OutIndices[Index]];
+			if (bDoubleKeys)
+			{
+				OutKeys.Add(FPSBulkOps::ToSortableKey(Accesses[Index].Read<double>(Target)));
+			}
+			else if (bAnyUInt64)
+			{
+				OutKeys.Add(Accesses[Index].Read<uint64>(Target));
+			}
+			else
+			{
+				OutKeys.Add((uint64)Accesses[Index].Read<int64>(Target) ^ (1ull << 63));
+			}
+		}
+	}
+
+	template<typename PropertyType, typename ValueType>
+	bool GetDefaultValue(UClass* Class, FName VarName, ValueType& OutValue)
+	{
+		UProperty* Property = nullptr;
+		const void* Address = nullptr;
+		if (FPSPropertyCache::FindDefaultValue(Class, VarName, Property, Address))
+		{
+			if (PropertyType* ValueProp = Cast<PropertyType>(Property))
+			{
+				OutValue = ValueProp->GetPropertyValue(Address);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// A single value of Property's type, parsed from text
+	struct FPSParsedValue
+	{
+		FPSParsedValue()
+			: Property(nullptr)
+			, Data(nullptr)
+		{
+		}
+
+		~FPSParsedValue()
+		{
+			Reset();
+		}
+
+		bool Parse(const UProperty* InProperty, const FString& Text)
+		{
+			Reset();
+			Property = InProperty;
+			Data = FMemory::Malloc(Property->GetSize(), Property->GetMinAlignment());
+			Property->InitializeValue(Data);
+			return Property->ImportText(*Text, Data, PPF_None, nullptr) != nullptr;
+		}
+
+		void Reset()
+		{
+			if (Property)
+			{
+				Property->DestroyValue(Data);
+				FMemory::Free(Data);
+				Property = nullptr;
+				Data = nullptr;
+			}
+		}
+
+		const UProperty* Property;
+		void* Data;
+	};
+
+	// Journals the write for the value types FPSJournal knows, nothing for the rest
+	template<typename ValueType>
+	void RecordWrite(UObject* Target, FName VarName, const ValueType& OldValue, const ValueType& NewValue)
+	{
+	}
+
+	void RecordWrite(UObject* Target, FName VarName, float OldValue, float NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, int32 OldValue, int32 NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, int64 OldValue, int64 NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, bool OldValue, bool NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, uint8 OldValue, uint8 NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, UObject* OldValue, UObject* NewValue) { FPSJournal::Record(Target, VarName, (const UObject*)OldValue, (const UObject*)NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, FName OldValue, FName NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, const FString& OldValue, const FString& NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+	void RecordWrite(UObject* Target, FName VarName, const FText& OldValue, const FText& NewValue) { FPSJournal::Record(Target, VarName, OldValue, NewValue); }
+
+	template<typename PropertyType, typename ValueType>
+	bool GetCachedValue(UObject* Target, FName VarName, FPSInlineCache& Cache, ValueType& OutValue)
+	{
+		if (Target)
+		{
+			if (PropertyType* ValueProp = Cast<PropertyType>(FPSPropertyCache::FindProperty(Target->GetClass(), VarName, Cache)))
+			{
+				OutValue = ValueProp->GetPropertyValue_InContainer(Target);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	template<typename PropertyType, typename ValueType>
+	bool SetCachedValue(UObject* Target, FName VarName, FPSInlineCache& Cache, const ValueType& NewValue, ValueType& OutValue)
+	{
+		if (Target)
+		{
+			bool bObserved;
+			if (PropertyType* ValueProp = Cast<PropertyType>(FPSPropertyCache::FindProperty(Target->GetClass(), VarName, Cache, bObserved)))
+			{
+				FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+				if (FPSJournal::IsEnabled())
+				{
+					RecordWrite(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+				}
+				ValueProp->SetPropertyValue_InContainer(Target, NewValue);
+				OutValue = ValueProp->GetPropertyValue_InContainer(Target);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// What SetValueByName and SetValueByStringName do once they found the property
+	bool WriteValue(UObject* Target, const UProperty* ValueProp, const FPSValue& NewValue)
+	{
+		FPSObservedWrite ObservedWrite(Target, ValueProp, FPSPropertyCache::IsObserved(ValueProp->GetFName()));
+		void* Address = ValueProp->ContainerPtrToValuePtr<void>(Target);
+		if (!FPSJournal::IsEnabled())
+		{
+			return NewValue.WriteTo(ValueProp, Address);
+		}
+
+		// The journal needs the old value, which the write is about to overwrite
+		void* OldValue = FMemory::Malloc(ValueProp->GetSize(), ValueProp->GetMinAlignment());
+		ValueProp->InitializeValue(OldValue);
+		ValueProp->CopyCompleteValue(OldValue, Address);
+
+		const bool bWritten = NewValue.WriteTo(ValueProp, Address);
+		if (bWritten)
+		{
+			FPSJournal::RecordProperty(Target, ValueProp, OldValue, Address);
+		}
+
+		ValueProp->DestroyValue(OldValue);
+		FMemory::Free(OldValue);
+		return bWritten;
+	}
+
+	int32 IndicesToObjects(const TArray<UObject*>& Targets, const TArray<int32>& Indices, TArray<UObject*>& OutMatches)
+	{
+		OutMatches.Reset(Indices.Num());
+		for (int32 Index : Indices)
+		{
+			OutMatches.Add(Targets[Index]);
+		}
+		return OutMatches.Num();
+	}
+}
 
 ///Getters and setters
 //Setters
@@ -11,9 +366,15 @@ bool UPSData::SetFloatByName(UObject * Target, FName VarName, float NewValue, fl
 	if (Target)
 	{
 		float FoundValue;
-		UFloatProperty* ValueProp = FindField<UFloatProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UFloatProperty* ValueProp = FPSPropertyCache::FindProperty<UFloatProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -28,9 +389,15 @@ bool UPSData::SetIntByName(UObject * Target, FName VarName, int NewValue, int &
 	if (Target)
 	{
 		int FoundValue;
-		UIntProperty* ValueProp = FindField<UIntProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UIntProperty* ValueProp = FPSPropertyCache::FindProperty<UIntProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), (int32)NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -46,9 +413,15 @@ bool UPSData::SetInt64ByName(UObject * Target, FName VarName, int64 NewValue, in
 	if (Target)
 	{
 		int64 FoundValue;
-		UUInt64Property* ValueProp = FindField<UUInt64Property>(Target->GetClass(), VarName);
+		bool bObserved;
+		UUInt64Property* ValueProp = FPSPropertyCache::FindProperty<UUInt64Property>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, (int64)ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -63,9 +436,15 @@ bool UPSData::SetBoolByName(UObject * Target, FName VarName, bool NewValue, bool
 	if (Target)
 	{
 		bool FoundValue;
-		UBoolProperty* ValueProp = FindField<UBoolProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UBoolProperty* ValueProp = FPSPropertyCache::FindProperty<UBoolProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -80,9 +459,15 @@ bool UPSData::SetNameByName(UObject * Target, FName VarName, FName NewValue, FNa
 	if (Target)
 	{
 		FName FoundValue;
-		UNameProperty* ValueProp = FindField<UNameProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UNameProperty* ValueProp = FPSPropertyCache::FindProperty<UNameProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -97,9 +482,15 @@ bool UPSData::SetObjectByName(UObject * Target, FName VarName, UObject* NewValue
 	if (Target)
 	{
 		UObject* FoundValue = nullptr;
-		UObjectProperty* ValueProp = FindField<UObjectProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UObjectProperty* ValueProp = FPSPropertyCache::FindProperty<UObjectProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, (const UObject*)ValueProp->GetPropertyValue_InContainer(Target), (const UObject*)NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -116,7 +507,7 @@ bool UPSData::SetClassByName(UObject * Target, FName VarName, class UClass* NewV
 	if (Target)
 	{
 		class UClass FoundValue;
-		UClassProperty* ValueProp = FindField<UClassProperty>(Target->GetClass(), VarName);
+		UClassProperty* ValueProp = FPSPropertyCache::FindProperty<UClassProperty>(Target->GetClass(), VarName);
 		if (ValueProp)
 		{
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
@@ -134,9 +525,15 @@ bool UPSData::SetByteByName(UObject * Target, FName VarName, uint8 NewValue, uin
 	if (Target)
 	{
 		uint8 FoundValue;
-		UByteProperty* ValueProp = FindField<UByteProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UByteProperty* ValueProp = FPSPropertyCache::FindProperty<UByteProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -146,14 +543,20 @@ bool UPSData::SetByteByName(UObject * Target, FName VarName, uint8 NewValue, uin
 	return false;
 }
 
-bool UPSData::SetStringByName(UObject * Target, FName VarName, FString NewValue, FString & OutValue)
+bool UPSData::SetStringByName(UObject * Target, FName VarName, const FString& NewValue, FString & OutValue)
 {
 	if (Target)
 	{
 		FString FoundValue;
-		UStrProperty* ValueProp = FindField<UStrProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UStrProperty* ValueProp = FPSPropertyCache::FindProperty<UStrProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -163,14 +566,20 @@ bool UPSData::SetStringByName(UObject * Target, FName VarName, FString NewValue,
 	return false;
 }
 
-bool UPSData::SetTextByName(UObject * Target, FName VarName, FText NewValue, FText & OutValue)
+bool UPSData::SetTextByName(UObject * Target, FName VarName, const FText& NewValue, FText & OutValue)
 {
 	if (Target)
 	{
 		FText FoundValue;
-		UTextProperty* ValueProp = FindField<UTextProperty>(Target->GetClass(), VarName);
+		bool bObserved;
+		UTextProperty* ValueProp = FPSPropertyCache::FindProperty<UTextProperty>(Target->GetClass(), VarName, bObserved);
 		if (ValueProp)
 		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, bObserved);
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, VarName, ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);
 			OutValue = FoundValue;
@@ -187,7 +596,7 @@ bool UPSData::SetStructByName(UObject * Target, FName VarName, UScriptStruct* Ne
 	if (Target)
 	{
 		UScriptStruct* FoundValue;
-		UStructProperty* ValueProp = FindField<UStructProperty>(Target->GetClass(), VarName);
+		UStructProperty* ValueProp = FPSPropertyCache::FindProperty<UStructProperty>(Target->GetClass(), VarName);
 		if (ValueProp)
 		{
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
@@ -207,7 +616,7 @@ bool UPSData::SetEnumByName(UObject * Target, FName VarName, uint8 NewValue, uin
 	if (Target)
 	{
 		uint8 FoundValue;
-		UEnumProperty* ValueProp = FindField<UEnumProperty>(Target->GetClass(), VarName);
+		UEnumProperty* ValueProp = FPSPropertyCache::FindProperty<UEnumProperty>(Target->GetClass(), VarName);
 		if (ValueProp)
 		{
 			ValueProp->SetPropertyValue_InContainer(Target, NewValue); //this actually sets the variable
@@ -227,7 +636,7 @@ bool UPSData::GetFloatByName(UObject * Target, FName VarName, float & OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		float FoundValue;
-		UFloatProperty* ValueProp = FindField<UFloatProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UFloatProperty* ValueProp = FPSPropertyCache::FindProperty<UFloatProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -243,7 +652,7 @@ bool UPSData::GetIntByName(UObject * Target, FName VarName, int & OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		int FoundValue;
-		UIntProperty* ValueProp = FindField<UIntProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UIntProperty* ValueProp = FPSPropertyCache::FindProperty<UIntProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -259,7 +668,7 @@ bool UPSData::GetInt64ByName(UObject * Target, FName VarName, int64 & OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		int64 FoundValue;
-		UInt64Property* ValueProp = FindField<UInt64Property>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UInt64Property* ValueProp = FPSPropertyCache::FindProperty<UInt64Property>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -275,7 +684,7 @@ bool UPSData::GetBoolByName(UObject * Target, FName VarName, bool &OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		bool FoundValue;
-		UBoolProperty* ValueProp = FindField<UBoolProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UBoolProperty* ValueProp = FPSPropertyCache::FindProperty<UBoolProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -291,7 +700,7 @@ bool UPSData::GetNameByName(UObject * Target, FName VarName, FName & OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		FName FoundValue;
-		UNameProperty* ValueProp = FindField<UNameProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UNameProperty* ValueProp = FPSPropertyCache::FindProperty<UNameProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -307,7 +716,7 @@ bool UPSData::GetObjectByName(UObject * Target, FName VarName, UObject *& OutVal
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		UObject* FoundValue;
-		UObjectProperty* ValueProp = FindField<UObjectProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UObjectProperty* ValueProp = FPSPropertyCache::FindProperty<UObjectProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -323,7 +732,7 @@ bool UPSData::GetClassByName(UObject * Target, FName VarName, UClass *& OutValue
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		UClass* FoundValue;
-		UClassProperty* ValueProp = FindField<UClassProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UClassProperty* ValueProp = FPSPropertyCache::FindProperty<UClassProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target)->StaticClass();  // get the value from FloatProp
@@ -339,7 +748,7 @@ bool UPSData::GetByteByName(UObject * Target, FName VarName, uint8 & OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		uint8 FoundValue;
-		UInt8Property* ValueProp = FindField<UInt8Property>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UInt8Property* ValueProp = FPSPropertyCache::FindProperty<UInt8Property>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -355,7 +764,7 @@ bool UPSData::GetStringByName(UObject * Target, FName VarName, FString & OutValu
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		FString FoundValue;
-		UStrProperty* ValueProp = FindField<UStrProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UStrProperty* ValueProp = FPSPropertyCache::FindProperty<UStrProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -371,7 +780,7 @@ bool UPSData::GetTextByName(UObject * Target, FName VarName, FText & OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		FText FoundValue;
-		UTextProperty* ValueProp = FindField<UTextProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UTextProperty* ValueProp = FPSPropertyCache::FindProperty<UTextProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -388,7 +797,7 @@ bool UPSData::GetStructByName(UObject * Target, FName VarName, UScriptStruct *&
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		UScriptStruct* FoundValue;
-		UStructProperty* ValueProp = FindField<UStructProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UStructProperty* ValueProp = FPSPropertyCache::FindProperty<UStructProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -406,7 +815,7 @@ bool UPSData::GetEnumByName(UObject * Target, FName VarName, uint8 & OutValue)
 	if (Target) //make sure Target was set in blueprints. 
 	{
 		float FoundValue;
-		UEnumProperty* ValueProp = FindField<UEnumProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
+		UEnumProperty* ValueProp = FPSPropertyCache::FindProperty<UEnumProperty>(Target->GetClass(), VarName);  // try to find float property in Target named VarName
 		if (ValueProp) //if we found variable
 		{
 			FoundValue = ValueProp->GetPropertyValue_InContainer(Target);  // get the value from FloatProp
@@ -417,3 +826,822 @@ bool UPSData::GetEnumByName(UObject * Target, FName VarName, uint8 & OutValue)
 	*/
 	return false; // we haven't found variable return false
 }
+
+//Inline cached access
+
+bool UPSData::SetFloatByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, float NewValue, float& OutValue)
+{
+	return SetCachedValue<UFloatProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetIntByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, int NewValue, int& OutValue)
+{
+	return SetCachedValue<UIntProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetInt64ByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, int64 NewValue, int64& OutValue)
+{
+	return SetCachedValue<UInt64Property>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetBoolByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, bool NewValue, bool& OutValue)
+{
+	return SetCachedValue<UBoolProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetNameByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, FName NewValue, FName& OutValue)
+{
+	return SetCachedValue<UNameProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetObjectByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, UObject* NewValue, UObject*& OutValue)
+{
+	return SetCachedValue<UObjectProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetByteByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, uint8 NewValue, uint8& OutValue)
+{
+	return SetCachedValue<UByteProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetStringByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, const FString& NewValue, FString& OutValue)
+{
+	return SetCachedValue<UStrProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::SetTextByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, const FText& NewValue, FText& OutValue)
+{
+	return SetCachedValue<UTextProperty>(Target, VarName, Cache, NewValue, OutValue);
+}
+
+bool UPSData::GetFloatByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, float& OutValue)
+{
+	return GetCachedValue<UFloatProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetIntByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, int& OutValue)
+{
+	return GetCachedValue<UIntProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetInt64ByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, int64& OutValue)
+{
+	return GetCachedValue<UInt64Property>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetBoolByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, bool& OutValue)
+{
+	return GetCachedValue<UBoolProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetNameByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, FName& OutValue)
+{
+	return GetCachedValue<UNameProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetObjectByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, UObject*& OutValue)
+{
+	return GetCachedValue<UObjectProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetByteByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, uint8& OutValue)
+{
+	return GetCachedValue<UByteProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetStringByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, FString& OutValue)
+{
+	return GetCachedValue<UStrProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::GetTextByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, FText& OutValue)
+{
+	return GetCachedValue<UTextProperty>(Target, VarName, Cache, OutValue);
+}
+
+bool UPSData::ReadValueByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, const UProperty* ValueProperty, void* ValueAddress)
+{
+	if (!Target || !ValueProperty || !ValueAddress)
+	{
+		return false;
+	}
+
+	// Only the lookup is cached, the value is read again every time so writes since the last evaluation show up
+	const UProperty* Property = FPSPropertyCache::FindProperty(Target->GetClass(), VarName, Cache);
+	const UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property);
+	const UBoolProperty* ValueBoolProperty = Cast<UBoolProperty>(ValueProperty);
+	if (BoolProperty && ValueBoolProperty)
+	{
+		// Either side may be a bitfield, so go through the bool accessors rather than copying bytes
+		ValueBoolProperty->SetPropertyValue(ValueAddress, BoolProperty->GetPropertyValue_InContainer(Target));
+		return true;
+	}
+	if (Property && Property->SameType(ValueProperty))
+	{
+		ValueProperty->CopyCompleteValue(ValueAddress, Property->ContainerPtrToValuePtr<void>(Target));
+		return true;
+	}
+	return false;
+}
+
+//Custom thunks
+
+#define PS_SETTER_THUNK(FunctionName, GetNewValue, GetOutValue) \
+	DEFINE_FUNCTION(UPSData::exec##FunctionName) \
+	{ \
+		P_GET_OBJECT(UObject, Target); \
+		P_GET_PROPERTY(UNameProperty, VarName); \
+		GetNewValue; \
+		GetOutValue; \
+		P_FINISH; \
+		P_NATIVE_BEGIN; \
+		*(bool*)RESULT_PARAM = FunctionName(Target, VarName, NewValue, OutValue); \
+		P_NATIVE_END; \
+	}
+
+#define PS_GETTER_THUNK(FunctionName, GetOutValue) \
+	DEFINE_FUNCTION(UPSData::exec##FunctionName) \
+	{ \
+		P_GET_OBJECT(UObject, Target); \
+		P_GET_PROPERTY(UNameProperty, VarName); \
+		GetOutValue; \
+		P_FINISH; \
+		P_NATIVE_BEGIN; \
+		*(bool*)RESULT_PARAM = FunctionName(Target, VarName, OutValue); \
+		P_NATIVE_END; \
+	}
+
+#define PS_CACHED_SETTER_THUNK(FunctionName, GetNewValue, GetOutValue) \
+	DEFINE_FUNCTION(UPSData::exec##FunctionName) \
+	{ \
+		P_GET_OBJECT(UObject, Target); \
+		P_GET_PROPERTY(UNameProperty, VarName); \
+		P_GET_STRUCT_REF(FPSInlineCache, Cache); \
+		GetNewValue; \
+		GetOutValue; \
+		P_FINISH; \
+		P_NATIVE_BEGIN; \
+		*(bool*)RESULT_PARAM = FunctionName(Target, VarName, Cache, NewValue, OutValue); \
+		P_NATIVE_END; \
+	}
+
+#define PS_CACHED_GETTER_THUNK(FunctionName, GetOutValue) \
+	DEFINE_FUNCTION(UPSData::exec##FunctionName) \
+	{ \
+		P_GET_OBJECT(UObject, Target); \
+		P_GET_PROPERTY(UNameProperty, VarName); \
+		P_GET_STRUCT_REF(FPSInlineCache, Cache); \
+		GetOutValue; \
+		P_FINISH; \
+		P_NATIVE_BEGIN; \
+		*(bool*)RESULT_PARAM = FunctionName(Target, VarName, Cache, OutValue); \
+		P_NATIVE_END; \
+	}
+
+PS_SETTER_THUNK(SetFloatByName, P_GET_PROPERTY_REF(UFloatProperty, NewValue), P_GET_PROPERTY_REF(UFloatProperty, OutValue))
+PS_SETTER_THUNK(SetIntByName, P_GET_PROPERTY_REF(UIntProperty, NewValue), P_GET_PROPERTY_REF(UIntProperty, OutValue))
+PS_SETTER_THUNK(SetInt64ByName, P_GET_PROPERTY_REF(UInt64Property, NewValue), P_GET_PROPERTY_REF(UInt64Property, OutValue))
+PS_SETTER_THUNK(SetBoolByName, P_GET_UBOOL(NewValue), P_GET_UBOOL_REF(OutValue))
+PS_SETTER_THUNK(SetNameByName, P_GET_PROPERTY_REF(UNameProperty, NewValue), P_GET_PROPERTY_REF(UNameProperty, OutValue))
+PS_SETTER_THUNK(SetObjectByName, P_GET_OBJECT(UObject, NewValue), P_GET_OBJECT_REF(UObject, OutValue))
+PS_SETTER_THUNK(SetByteByName, P_GET_PROPERTY_REF(UByteProperty, NewValue), P_GET_PROPERTY_REF(UByteProperty, OutValue))
+PS_SETTER_THUNK(SetStringByName, P_GET_PROPERTY_REF(UStrProperty, NewValue), P_GET_PROPERTY_REF(UStrProperty, OutValue))
+PS_SETTER_THUNK(SetTextByName, P_GET_PROPERTY_REF(UTextProperty, NewValue), P_GET_PROPERTY_REF(UTextProperty, OutValue))
+
+PS_GETTER_THUNK(GetFloatByName, P_GET_PROPERTY_REF(UFloatProperty, OutValue))
+PS_GETTER_THUNK(GetIntByName, P_GET_PROPERTY_REF(UIntProperty, OutValue))
+PS_GETTER_THUNK(GetInt64ByName, P_GET_PROPERTY_REF(UInt64Property, OutValue))
+PS_GETTER_THUNK(GetBoolByName, P_GET_UBOOL_REF(OutValue))
+PS_GETTER_THUNK(GetNameByName, P_GET_PROPERTY_REF(UNameProperty, OutValue))
+PS_GETTER_THUNK(GetObjectByName, P_GET_OBJECT_REF(UObject, OutValue))
+PS_GETTER_THUNK(GetByteByName, P_GET_PROPERTY_REF(UByteProperty, OutValue))
+PS_GETTER_THUNK(GetStringByName, P_GET_PROPERTY_REF(UStrProperty, OutValue))
+PS_GETTER_THUNK(GetTextByName, P_GET_PROPERTY_REF(UTextProperty, OutValue))
+
+PS_CACHED_SETTER_THUNK(SetFloatByNameCached, P_GET_PROPERTY_REF(UFloatProperty, NewValue), P_GET_PROPERTY_REF(UFloatProperty, OutValue))
+PS_CACHED_SETTER_THUNK(SetIntByNameCached, P_GET_PROPERTY_REF(UIntProperty, NewValue), P_GET_PROPERTY_REF(UIntProperty, OutValue))
+PS_CACHED_SETTER_THUNK(SetInt64ByNameCached, P_GET_PROPERTY_REF(UInt64Property, NewValue), P_GET_PROPERTY_REF(UInt64Property, OutValue))
+PS_CACHED_SETTER_THUNK(SetBoolByNameCached, P_GET_UBOOL(NewValue), P_GET_UBOOL_REF(OutValue))
+PS_CACHED_SETTER_THUNK(SetNameByNameCached, P_GET_PROPERTY_REF(UNameProperty, NewValue), P_GET_PROPERTY_REF(UNameProperty, OutValue))
+PS_CACHED_SETTER_THUNK(SetObjectByNameCached, P_GET_OBJECT(UObject, NewValue), P_GET_OBJECT_REF(UObject, OutValue))
+PS_CACHED_SETTER_THUNK(SetByteByNameCached, P_GET_PROPERTY_REF(UByteProperty, NewValue), P_GET_PROPERTY_REF(UByteProperty, OutValue))
+PS_CACHED_SETTER_THUNK(SetStringByNameCached, P_GET_PROPERTY_REF(UStrProperty, NewValue), P_GET_PROPERTY_REF(UStrProperty, OutValue))
+PS_CACHED_SETTER_THUNK(SetTextByNameCached, P_GET_PROPERTY_REF(UTextProperty, NewValue), P_GET_PROPERTY_REF(UTextProperty, OutValue))
+
+PS_CACHED_GETTER_THUNK(GetFloatByNameCached, P_GET_PROPERTY_REF(UFloatProperty, OutValue))
+PS_CACHED_GETTER_THUNK(GetIntByNameCached, P_GET_PROPERTY_REF(UIntProperty, OutValue))
+PS_CACHED_GETTER_THUNK(GetInt64ByNameCached, P_GET_PROPERTY_REF(UInt64Property, OutValue))
+PS_CACHED_GETTER_THUNK(GetBoolByNameCached, P_GET_UBOOL_REF(OutValue))
+PS_CACHED_GETTER_THUNK(GetNameByNameCached, P_GET_PROPERTY_REF(UNameProperty, OutValue))
+PS_CACHED_GETTER_THUNK(GetObjectByNameCached, P_GET_OBJECT_REF(UObject, OutValue))
+PS_CACHED_GETTER_THUNK(GetByteByNameCached, P_GET_PROPERTY_REF(UByteProperty, OutValue))
+PS_CACHED_GETTER_THUNK(GetStringByNameCached, P_GET_PROPERTY_REF(UStrProperty, OutValue))
+PS_CACHED_GETTER_THUNK(GetTextByNameCached, P_GET_PROPERTY_REF(UTextProperty, OutValue))
+
+#undef PS_SETTER_THUNK
+#undef PS_GETTER_THUNK
+#undef PS_CACHED_SETTER_THUNK
+#undef PS_CACHED_GETTER_THUNK
+
+DEFINE_FUNCTION(UPSData::execGetValueByNameCached)
+{
+	P_GET_OBJECT(UObject, Target);
+	P_GET_PROPERTY(UNameProperty, VarName);
+	P_GET_STRUCT_REF(FPSInlineCache, Cache);
+
+	// Value is a wildcard, take whatever property the caller passed
+	Stack.MostRecentProperty = nullptr;
+	Stack.MostRecentPropertyAddress = nullptr;
+	Stack.StepCompiledIn<UProperty>(nullptr);
+	const UProperty* ValueProperty = Stack.MostRecentProperty;
+	void* ValueAddress = Stack.MostRecentPropertyAddress;
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+	*(bool*)RESULT_PARAM = ReadValueByNameCached(Target, VarName, Cache, ValueProperty, ValueAddress);
+	P_NATIVE_END;
+}
+
+//Type coercing getters
+
+bool UPSData::GetNumberByName(UObject* Target, FName VarName, double& OutValue)
+{
+	FPSNumericAccess Access;
+	if (Target && FPSPropertyCache::FindNumeric(Target->GetClass(), VarName, Access))
+	{
+		OutValue = Access.Read<double>(Target);
+		return true;
+	}
+	return false;
+}
+
+bool UPSData::GetNumberAsFloatByName(UObject* Target, FName VarName, float& OutValue)
+{
+	FPSNumericAccess Access;
+	if (Target && FPSPropertyCache::FindNumeric(Target->GetClass(), VarName, Access))
+	{
+		OutValue = Access.Read<float>(Target);
+		return true;
+	}
+	return false;
+}
+
+bool UPSData::GetNumberAsIntByName(UObject* Target, FName VarName, int& OutValue)
+{
+	FPSNumericAccess Access;
+	if (Target && FPSPropertyCache::FindNumeric(Target->GetClass(), VarName, Access))
+	{
+		OutValue = Access.Read<int32>(Target);
+		return true;
+	}
+	return false;
+}
+
+bool UPSData::GetNumberAsInt64ByName(UObject* Target, FName VarName, int64& OutValue)
+{
+	FPSNumericAccess Access;
+	if (Target && FPSPropertyCache::FindNumeric(Target->GetClass(), VarName, Access))
+	{
+		OutValue = Access.Read<int64>(Target);
+		return true;
+	}
+	return false;
+}
+
+//Variant access
+
+bool UPSData::GetValueByName(UObject* Target, FName VarName, FPSValue& OutValue)
+{
+	if (Target)
+	{
+		if (UProperty* ValueProp = FPSPropertyCache::FindProperty(Target->GetClass(), VarName))
+		{
+			return OutValue.ReadFrom(ValueProp, ValueProp->ContainerPtrToValuePtr<void>(Target));
+		}
+	}
+	return false;
+}
+
+bool UPSData::SetValueByName(UObject* Target, FName VarName, const FPSValue& NewValue)
+{
+	if (Target)
+	{
+		if (UProperty* ValueProp = FPSPropertyCache::FindProperty(Target->GetClass(), VarName))
+		{
+			return WriteValue(Target, ValueProp, NewValue);
+		}
+	}
+	return false;
+}
+
+//String name access
+
+bool UPSData::GetFloatByStringName(UObject* Target, const FString& VarName, float& OutValue)
+{
+	if (Target)
+	{
+		if (UFloatProperty* ValueProp = Cast<UFloatProperty>(FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName)))
+		{
+			OutValue = ValueProp->GetPropertyValue_InContainer(Target);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UPSData::SetFloatByStringName(UObject* Target, const FString& VarName, float NewValue)
+{
+	if (Target)
+	{
+		if (UFloatProperty* ValueProp = Cast<UFloatProperty>(FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName)))
+		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, FPSPropertyCache::IsObserved(ValueProp->GetFName()));
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, ValueProp->GetFName(), ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
+			ValueProp->SetPropertyValue_InContainer(Target, NewValue);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UPSData::GetIntByStringName(UObject* Target, const FString& VarName, int& OutValue)
+{
+	if (Target)
+	{
+		if (UIntProperty* ValueProp = Cast<UIntProperty>(FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName)))
+		{
+			OutValue = ValueProp->GetPropertyValue_InContainer(Target);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UPSData::SetIntByStringName(UObject* Target, const FString& VarName, int NewValue)
+{
+	if (Target)
+	{
+		if (UIntProperty* ValueProp = Cast<UIntProperty>(FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName)))
+		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, FPSPropertyCache::IsObserved(ValueProp->GetFName()));
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, ValueProp->GetFName(), ValueProp->GetPropertyValue_InContainer(Target), (int32)NewValue);
+			}
+			ValueProp->SetPropertyValue_InContainer(Target, NewValue);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UPSData::GetBoolByStringName(UObject* Target, const FString& VarName, bool& OutValue)
+{
+	if (Target)
+	{
+		if (UBoolProperty* ValueProp = Cast<UBoolProperty>(FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName)))
+		{
+			OutValue = ValueProp->GetPropertyValue_InContainer(Target);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UPSData::SetBoolByStringName(UObject* Target, const FString& VarName, bool NewValue)
+{
+	if (Target)
+	{
+		if (UBoolProperty* ValueProp = Cast<UBoolProperty>(FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName)))
+		{
+			FPSObservedWrite ObservedWrite(Target, ValueProp, FPSPropertyCache::IsObserved(ValueProp->GetFName()));
+			if (FPSJournal::IsEnabled())
+			{
+				FPSJournal::Record(Target, ValueProp->GetFName(), ValueProp->GetPropertyValue_InContainer(Target), NewValue);
+			}
+			ValueProp->SetPropertyValue_InContainer(Target, NewValue);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool UPSData::GetValueByStringName(UObject* Target, const TCHAR* VarName, int32 VarNameLen, FPSValue& OutValue)
+{
+	if (Target)
+	{
+		if (UProperty* ValueProp = FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName, VarNameLen))
+		{
+			return OutValue.ReadFrom(ValueProp, ValueProp->ContainerPtrToValuePtr<void>(Target));
+		}
+	}
+	return false;
+}
+
+bool UPSData::SetValueByStringName(UObject* Target, const TCHAR* VarName, int32 VarNameLen, const FPSValue& NewValue)
+{
+	if (Target)
+	{
+		if (UProperty* ValueProp = FPSPropertyCache::FindPropertyByString(Target->GetClass(), VarName, VarNameLen))
+		{
+			return WriteValue(Target, ValueProp, NewValue);
+		}
+	}
+	return false;
+}
+
+//Class default access
+
+bool UPSData::GetDefaultFloatByName(UClass* Class, FName VarName, float& OutValue)
+{
+	return GetDefaultValue<UFloatProperty>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultIntByName(UClass* Class, FName VarName, int& OutValue)
+{
+	return GetDefaultValue<UIntProperty>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultInt64ByName(UClass* Class, FName VarName, int64& OutValue)
+{
+	return GetDefaultValue<UInt64Property>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultBoolByName(UClass* Class, FName VarName, bool& OutValue)
+{
+	return GetDefaultValue<UBoolProperty>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultNameByName(UClass* Class, FName VarName, FName& OutValue)
+{
+	return GetDefaultValue<UNameProperty>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultObjectByName(UClass* Class, FName VarName, UObject*& OutValue)
+{
+	return GetDefaultValue<UObjectProperty>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultByteByName(UClass* Class, FName VarName, uint8& OutValue)
+{
+	return GetDefaultValue<UByteProperty>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultStringByName(UClass* Class, FName VarName, FString& OutValue)
+{
+	return GetDefaultValue<UStrProperty>(Class, VarName, OutValue);
+}
+
+bool UPSData::GetDefaultValueByName(UClass* Class, FName VarName, FPSValue& OutValue)
+{
+	UProperty* Property = nullptr;
+	const void* Address = nullptr;
+	return FPSPropertyCache::FindDefaultValue(Class, VarName, Property, Address) && OutValue.ReadFrom(Property, Address);
+}
+
+//Struct transfer
+
+int32 UPSData::CopyStructToObject(const UScriptStruct* StructType, const void* StructData, UObject* Target)
+{
+	if (!StructType || !StructData || !Target)
+	{
+		return 0;
+	}
+
+	const FPSLayoutSchema* Schema = FPSLayoutSchema::GetByNames(Target->GetClass(), StructType);
+	if (!Schema)
+	{
+		return 0;
+	}
+
+	// Observed variables get the same before and after comparison as the single variable setters, reported once the copy is done.
+	// The schema binds the struct's members in field order, by display name.
+	TArray<TUniquePtr<FPSObservedWrite>, TInlineAllocator<4>> ObservedWrites;
+	if (FPSPropertyCache::IsAnyObserved())
+	{
+		int32 VarIndex = 0;
+		for (TFieldIterator<UProperty> It(StructType); It; ++It, ++VarIndex)
+		{
+			const FName VarName(*StructType->PropertyNameToDisplayName(It->GetFName()));
+			bool bObserved = false;
+			UProperty* Property = Schema->IsBound(VarIndex) ? FPSPropertyCache::FindProperty(Target->GetClass(), VarName, bObserved) : nullptr;
+			if (Property && bObserved)
+			{
+				ObservedWrites.Add(MakeUnique<FPSObservedWrite>(Target, Property, true));
+			}
+		}
+	}
+
+	return Schema->Write(Target, StructData) ? Schema->NumBound() : 0;
+}
+
+int32 UPSData::CopyObjectToStruct(const UObject* Target, const UScriptStruct* StructType, void* StructData)
+{
+	if (!StructType || !StructData || !Target)
+	{
+		return 0;
+	}
+
+	const FPSLayoutSchema* Schema = FPSLayoutSchema::GetByNames(Target->GetClass(), StructType);
+	return (Schema && Schema->Read(Target, StructData)) ? Schema->NumBound() : 0;
+}
+
+DEFINE_FUNCTION(UPSData::execCopyStructToObjectByNames)
+{
+	// Struct is a wildcard, take whatever the caller passed and only use it if it is a struct
+	Stack.MostRecentProperty = nullptr;
+	Stack.MostRecentPropertyAddress = nullptr;
+	Stack.StepCompiledIn<UStructProperty>(nullptr);
+	const UStructProperty* StructProperty = Cast<UStructProperty>(Stack.MostRecentProperty);
+	const void* StructData = Stack.MostRecentPropertyAddress;
+	P_GET_OBJECT(UObject, Target);
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+	*(int32*)RESULT_PARAM = StructProperty ? CopyStructToObject(StructProperty->Struct, StructData, Target) : 0;
+	P_NATIVE_END;
+}
+
+DEFINE_FUNCTION(UPSData::execCopyObjectToStructByNames)
+{
+	P_GET_OBJECT(UObject, Target);
+	Stack.MostRecentProperty = nullptr;
+	Stack.MostRecentPropertyAddress = nullptr;
+	Stack.StepCompiledIn<UStructProperty>(nullptr);
+	const UStructProperty* StructProperty = Cast<UStructProperty>(Stack.MostRecentProperty);
+	void* StructData = Stack.MostRecentPropertyAddress;
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+	*(int32*)RESULT_PARAM = StructProperty ? CopyObjectToStruct(Target, StructProperty->Struct, StructData) : 0;
+	P_NATIVE_END;
+}
+
+//Observers
+
+void UPSData::ObserveVariable(UObject* Target, FName VarName, FPSPropertyChangedDynamic OnChanged)
+{
+	FPSPropertyObservers::ObserveObject(Target, VarName, OnChanged);
+}
+
+void UPSData::ObserveClassVariable(UClass* Class, FName VarName, FPSPropertyChangedDynamic OnChanged)
+{
+	FPSPropertyObservers::ObserveClass(Class, VarName, OnChanged);
+}
+
+void UPSData::StopObservingVariable(FPSPropertyChangedDynamic OnChanged)
+{
+	FPSPropertyObservers::Unobserve(OnChanged);
+}
+
+//Waiting
+
+void UPSData::WaitUntilValueByName(UObject* WorldContextObject, UObject* Target, FName VarName, EPSCompareOp Op, float Operand, FLatentActionInfo LatentInfo)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World)
+	{
+		return;
+	}
+
+	// Like Delay, calling it again while the node is still waiting does nothing
+	FLatentActionManager& LatentActionManager = World->GetLatentActionManager();
+	if (!LatentActionManager.FindExistingAction<FPSWaitForConditionAction>(LatentInfo.CallbackTarget, LatentInfo.UUID))
+	{
+		LatentActionManager.AddNewAction(LatentInfo.CallbackTarget, LatentInfo.UUID,
+			new FPSWaitForConditionAction(LatentInfo, FPSConditions::WaitFor(Target, VarName, Op, Operand)));
+	}
+}
+
+//Bulk operations
+
+int32 UPSData::ApplyFloatOpByName(const TArray<UObject*>& Targets, FName VarName, EPSBulkOp Op, float A, float B)
+{
+	return ApplyBulkKernel<float>(Targets, VarName, UFloatProperty::StaticClass(), [Op, A, B](float* Data, int32 Num)
+	{
+		FPSBulkOps::Apply(Data, Num, Op, A, B);
+		return true;
+	});
+}
+
+int32 UPSData::ApplyIntOpByName(const TArray<UObject*>& Targets, FName VarName, EPSBulkOp Op, int A, int B)
+{
+	return ApplyBulkKernel<int32>(Targets, VarName, UIntProperty::StaticClass(), [Op, A, B](int32* Data, int32 Num)
+	{
+		return FPSBulkOps::Apply(Data, Num, Op, A, B);
+	});
+}
+
+int32 UPSData::SetValuesFromStringByName(const TArray<UObject*>& Targets, FName VarName, const FString& Value)
+{
+	int32 NumSet = 0;
+	const UClass* LastClass = nullptr;
+	UProperty* LastProperty = nullptr;
+	bool bLastObserved = false;
+	FPSParsedValue Parsed;
+
+	for (UObject* Target : Targets)
+	{
+		if (!Target)
+		{
+			continue;
+		}
+
+		if (Target->GetClass() != LastClass)
+		{
+			LastClass = Target->GetClass();
+			LastProperty = FPSPropertyCache::FindProperty(LastClass, VarName, bLastObserved);
+
+			// Classes sharing the variable (e.g. it's declared on a common parent) reuse the parsed value
+			if (LastProperty && LastProperty != Parsed.Property)
+			{
+				if (LastProperty->ArrayDim != 1 || !Parsed.Parse(LastProperty, Value))
+				{
+					Parsed.Reset();
+					LastProperty = nullptr;
+				}
+			}
+		}
+
+		if (LastProperty)
+		{
+			FPSObservedWrite ObservedWrite(Target, LastProperty, bLastObserved);
+			void* Address = LastProperty->ContainerPtrToValuePtr<void>(Target);
+			if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(LastProperty))
+			{
+				// Bitfields share their storage, so set just the bit rather than copying the whole field
+				BoolProperty->SetPropertyValue(Address, BoolProperty->GetPropertyValue(Parsed.Data));
+			}
+			else
+			{
+				LastProperty->CopySingleValue(Address, Parsed.Data);
+			}
+			++NumSet;
+		}
+	}
+
+	return NumSet;
+}
+
+//Queries
+
+int32 UPSData::QueryObjectsByFloat(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, float Operand, TArray<UObject*>& OutMatches)
+{
+	TArray<int32> Indices;
+	QueryIndices<float>(Targets, VarName, UFloatProperty::StaticClass(), Op, Operand, Indices);
+	return IndicesToObjects(Targets, Indices, OutMatches);
+}
+
+int32 UPSData::QueryIndicesByFloat(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, float Operand, TArray<int32>& OutIndices)
+{
+	QueryIndices<float>(Targets, VarName, UFloatProperty::StaticClass(), Op, Operand, OutIndices);
+	return OutIndices.Num();
+}
+
+int32 UPSData::QueryObjectsByInt(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, int Operand, TArray<UObject*>& OutMatches)
+{
+	TArray<int32> Indices;
+	QueryIndices<int32>(Targets, VarName, UIntProperty::StaticClass(), Op, Operand, Indices);
+	return IndicesToObjects(Targets, Indices, OutMatches);
+}
+
+int32 UPSData::QueryIndicesByInt(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, int Operand, TArray<int32>& OutIndices)
+{
+	QueryIndices<int32>(Targets, VarName, UIntProperty::StaticClass(), Op, Operand, OutIndices);
+	return OutIndices.Num();
+}
+
+//Sorting
+
+int32 UPSData::SortObjectsByName(TArray<UObject*>& Targets, FName VarName, bool bDescending)
+{
+	// Extract every key once, so the sort itself never touches the objects
+	TArray<uint64> Keys;
+	TArray<int32> Order;
+	TArray<int32> Unsorted;
+	GatherSortKeys(Targets, VarName, Keys, Order, Unsorted);
+
+	if (bDescending)
+	{
+		// Inverting the key flips the order while keeping equal keys in their original order
+		for (uint64& Key : Keys)
+		{
+			Key = ~Key;
+		}
+	}
+
+	const int32 NumSorted = Order.Num();
+	if (NumSorted < RadixSortThreshold)
+	{
+		TArray<int32> Permutation;
+		Permutation.SetNumUninitialized(NumSorted);
+		for (int32 Index = 0; Index < NumSorted; ++Index)
+		{
+			Permutation[Index] = Index;
+		}
+
+		Algo::StableSort(Permutation, [&Keys](int32 A, int32 B) { return Keys[A] < Keys[B]; });
+
+		TArray<int32> SortedOrder;
+		SortedOrder.SetNumUninitialized(NumSorted);
+		for (int32 Index = 0; Index < NumSorted; ++Index)
+		{
+			SortedOrder[Index] = Order[Permutation[Index]];
+		}
+		Order = MoveTemp(SortedOrder);
+	}
+	else
+	{
+		FPSBulkOps::RadixSort(Keys, Order);
+	}
+
+	Order.Append(Unsorted);
+
+	TArray<UObject*> Sorted;
+	Sorted.SetNumUninitialized(Targets.Num());
+	for (int32 Index = 0; Index < Order.Num(); ++Index)
+	{
+		Sorted[Index] = Targets[Order[Index]];
+	}
+	Targets = MoveTemp(Sorted);
+
+	return NumSorted;
+}
+
+//Reductions
+
+bool UPSData::ReduceByName(const TArray<UObject*>& Targets, FName VarName, FPSReductionResult& OutResult)
+{
+	OutResult = FPSReductionResult();
+
+	TArray<double> Values;
+	TArray<int32> Indices;
+	GatherNumericValues(Targets, VarName, Values, Indices);
+	if (Values.Num() == 0)
+	{
+		return false;
+	}
+
+	// Each chunk reduces on its own, then the partials are merged in order so ties still report the first index
+	const int32 NumChunks = FMath::DivideAndRoundUp(Values.Num(), QueryChunkSize);
+	TArray<FPSReductionPartial> Partials;
+	Partials.SetNum(NumChunks);
+
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		const int32 FirstIndex = ChunkIndex * QueryChunkSize;
+		const int32 Num = FMath::Min(QueryChunkSize, Values.Num() - FirstIndex);
+		Partials[ChunkIndex] = FPSBulkOps::Reduce(Values.GetData() + FirstIndex, Num, Indices.GetData() + FirstIndex);
+	}, Values.Num() < ParallelQueryThreshold);
+
+	FPSReductionPartial Total;
+	for (const FPSReductionPartial& Partial : Partials)
+	{
+		Total.Merge(Partial);
+	}
+
+	OutResult.Count = Total.Count;
+	OutResult.Sum = (float)Total.Sum;
+	OutResult.Min = (float)Total.Min;
+	OutResult.Max = (float)Total.Max;
+	OutResult.MinIndex = Total.MinIndex;
+	OutResult.MaxIndex = Total.MaxIndex;
+	OutResult.Mean = (float)Total.Mean;
+	OutResult.Variance = (float)(Total.M2 / Total.Count);
+	return true;
+}
+
+int32 UPSData::HistogramByName(const TArray<UObject*>& Targets, FName VarName, float Min, float Max, int32 NumBuckets, TArray<int32>& OutBuckets)
+{
+	OutBuckets.Reset();
+	if (NumBuckets <= 0 || Max <= Min)
+	{
+		return 0;
+	}
+
+	OutBuckets.SetNumZeroed(NumBuckets);
+
+	TArray<double> Values;
+	TArray<int32> Indices;
+	GatherNumericValues(Targets, VarName, Values, Indices);
+
+	const double BucketScale = NumBuckets / ((double)Max - (double)Min);
+	int32 NumCounted = 0;
+	for (double Value : Values)
+	{
+		if (FMath::IsNaN(Value))
+		{
+			continue;
+		}
+
+		// Clamped while still a double, far out of range values don't fit an int32
+		const double Bucket = FMath::Clamp(FMath::FloorToDouble((Value - Min) * BucketScale), 0.0, (double)(NumBuckets - 1));
+		++OutBuckets[(int32)Bucket];
+		++NumCounted;
+	}
+
+	return NumCounted;
+}
@@ -3,7 +3,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/LatentActionManager.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "PSTypes.h"
+#include "PSValue.h"
 
 #include "PSData.generated.h"
 
@@ -24,35 +27,35 @@ public:
 
 	///Actual Setters and getter
 	//Setters
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool SetFloatByName(UObject* Target, FName VarName, float NewValue, float &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool SetIntByName(UObject* Target, FName VarName, int NewValue, int &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool SetInt64ByName(UObject* Target, FName VarName, int64 NewValue, int64 &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool SetBoolByName(UObject* Target, FName VarName, bool NewValue, bool &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool SetNameByName(UObject* Target, FName VarName, FName NewValue, FName &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool SetObjectByName(UObject* Target, FName VarName, UObject* NewValue, UObject* &OutValue);
 
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
 		static bool SetClassByName(UObject* Target, FName VarName, class UClass* NewValue, class UClass* &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool SetByteByName(UObject* Target, FName VarName, uint8 NewValue, uint8 &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
-		static bool SetStringByName(UObject* Target, FName VarName, FString NewValue, FString &OutValue);
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
+		static bool SetStringByName(UObject* Target, FName VarName, const FString& NewValue, FString &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
-		static bool SetTextByName(UObject* Target, FName VarName, FText NewValue, FText &OutValue);
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
+		static bool SetTextByName(UObject* Target, FName VarName, const FText& NewValue, FText &OutValue);
 
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
 		static bool SetStructByName(UObject* Target, FName VarName, UScriptStruct* NewValue, UScriptStruct* &OutValue);
@@ -61,34 +64,34 @@ public:
 		static bool SetEnumByName(UObject* Target, FName VarName, uint8 NewValue, uint8 &OutValue);
 
 	//Getters
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetFloatByName(UObject* Target, FName VarName, float &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetIntByName(UObject* Target, FName VarName, int &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetInt64ByName(UObject* Target, FName VarName, int64 &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetBoolByName(UObject* Target, FName VarName, bool &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetNameByName(UObject* Target, FName VarName, FName &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetObjectByName(UObject* Target, FName VarName, UObject* &OutValue);
 
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
 		static bool GetClassByName(UObject* Target, FName VarName, class UClass* &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetByteByName(UObject* Target, FName VarName, uint8 &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetStringByName(UObject* Target, FName VarName, FString &OutValue);
 
-	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
+	UFUNCTION(BlueprintCallable, CustomThunk, BlueprintInternalUseOnly)
 		static bool GetTextByName(UObject* Target, FName VarName, FText &OutValue);
 
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
@@ -97,4 +100,275 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly)
 		static bool GetEnumByName(UObject* Target, FName VarName, uint8 &OutValue);
 
+	//Inline cached access
+	//What the getter/setter nodes call, each node passing its own FPSInlineCache. Types without a cached version use the plain functions.
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetFloatByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, float NewValue, float &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetIntByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, int NewValue, int &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetInt64ByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, int64 NewValue, int64 &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetBoolByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, bool NewValue, bool &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetNameByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, FName NewValue, FName &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetObjectByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, UObject* NewValue, UObject* &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetByteByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, uint8 NewValue, uint8 &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetStringByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, const FString& NewValue, FString &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool SetTextByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, const FText& NewValue, FText &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetFloatByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, float &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetIntByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, int &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetInt64ByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, int64 &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetBoolByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, bool &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetNameByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, FName &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetObjectByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, UObject* &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetByteByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, uint8 &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetStringByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, FString &OutValue);
+
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true"), Category = "nfPopulationSystem")
+		static bool GetTextByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, FText &OutValue);
+
+	/**
+	 * What the pure getter node calls. Reads VarName into Value, finding the property through the node's inline cache like the accessors above.
+	 * The value itself is read on every evaluation. Value takes the type of the pin it is connected to.
+	 */
+	UFUNCTION(BlueprintPure, CustomThunk, meta = (BlueprintInternalUseOnly = "true", CustomStructureParam = "Value"), Category = "nfPopulationSystem")
+		static bool GetValueByNameCached(UObject* Target, FName VarName, UPARAM(ref) FPSInlineCache& Cache, int32& Value);
+
+	/** GetValueByNameCached for a value of type ValueProperty at ValueAddress. Not overloaded, the nodes look the function up by name. */
+	static bool ReadValueByNameCached(UObject* Target, FName VarName, FPSInlineCache& Cache, const UProperty* ValueProperty, void* ValueAddress);
+
+	//Type coercing getters
+	/** Reads the variable named VarName whatever numeric type it is stored as (float, double, any int, byte or enum). Not exposed, Blueprints have no double. */
+	static bool GetNumberByName(UObject* Target, FName VarName, double& OutValue);
+
+	/** Reads any numeric variable as a float. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetNumberAsFloatByName(UObject* Target, FName VarName, float& OutValue);
+
+	/** Reads any numeric variable as an int. Floating point values are truncated, saturating at the int's range (NaN reads as 0). */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetNumberAsIntByName(UObject* Target, FName VarName, int& OutValue);
+
+	/** Reads any numeric variable as an int64. Floating point values are truncated, saturating at the int64's range (NaN reads as 0). */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetNumberAsInt64ByName(UObject* Target, FName VarName, int64& OutValue);
+
+	//Variant access
+	/** Reads the variable named VarName, whatever its type, in one lookup. Not exposed, FPSValue is a C++ only type. */
+	static bool GetValueByName(UObject* Target, FName VarName, FPSValue& OutValue);
+
+	/** Writes NewValue to the variable named VarName. Fails if the types don't match, numeric values convert between widths. */
+	static bool SetValueByName(UObject* Target, FName VarName, const FPSValue& NewValue);
+
+	//String name access
+	//For names built at runtime (e.g. "Skill_" + Index). These skip FName construction, see FPSPropertyCache::FindPropertyByString.
+	//They're separate names rather than overloads so GET_FUNCTION_NAME_CHECKED keeps working on the FName versions.
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetFloatByStringName(UObject* Target, const FString& VarName, float &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool SetFloatByStringName(UObject* Target, const FString& VarName, float NewValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetIntByStringName(UObject* Target, const FString& VarName, int &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool SetIntByStringName(UObject* Target, const FString& VarName, int NewValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetBoolByStringName(UObject* Target, const FString& VarName, bool &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool SetBoolByStringName(UObject* Target, const FString& VarName, bool NewValue);
+
+	static bool GetValueByStringName(UObject* Target, const TCHAR* VarName, int32 VarNameLen, FPSValue& OutValue);
+	static bool SetValueByStringName(UObject* Target, const TCHAR* VarName, int32 VarNameLen, const FPSValue& NewValue);
+
+	//Class default access
+	//Reads straight off the class default object, for tuning constants. The CDO address is cached per class, see FPSPropertyCache::FindDefaultValue.
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultFloatByName(UClass* Class, FName VarName, float &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultIntByName(UClass* Class, FName VarName, int &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultInt64ByName(UClass* Class, FName VarName, int64 &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultBoolByName(UClass* Class, FName VarName, bool &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultNameByName(UClass* Class, FName VarName, FName &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultObjectByName(UClass* Class, FName VarName, UObject* &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultByteByName(UClass* Class, FName VarName, uint8 &OutValue);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool GetDefaultStringByName(UClass* Class, FName VarName, FString &OutValue);
+
+	static bool GetDefaultValueByName(UClass* Class, FName VarName, FPSValue& OutValue);
+
+	//Struct transfer
+	//Copies every member of a struct to the same-named variable of an object, or back. The mapping is worked out once per struct type and class
+	//(see FPSLayoutSchema::GetByNames), numbers of different types are converted, and members with no match are skipped. Not journaled, but changes to observed variables are reported.
+	/** Copies Struct into the same-named variables of Target. Returns how many members were copied. */
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (CustomStructureParam = "Struct"), Category = "nfPopulationSystem")
+		static int32 CopyStructToObjectByNames(const int32& Struct, UObject* Target);
+
+	/** Fills the members of Struct from the same-named variables of Target. Returns how many members were copied. */
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (CustomStructureParam = "Struct"), Category = "nfPopulationSystem")
+		static int32 CopyObjectToStructByNames(UObject* Target, int32& Struct);
+
+	static int32 CopyStructToObject(const UScriptStruct* StructType, const void* StructData, UObject* Target);
+	static int32 CopyObjectToStruct(const UObject* Target, const UScriptStruct* StructType, void* StructData);
+
+	//Observers
+	//Change notifications for variables written through the setters above, handed out at the end of the frame. See FPSPropertyObservers.
+	/** Calls OnChanged at the end of any frame in which VarName changed on Target. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static void ObserveVariable(UObject* Target, FName VarName, FPSPropertyChangedDynamic OnChanged);
+
+	/** Calls OnChanged at the end of any frame in which VarName changed on an object of Class, once per object. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static void ObserveClassVariable(UClass* Class, FName VarName, FPSPropertyChangedDynamic OnChanged);
+
+	/** Stops every observation OnChanged was registered for. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static void StopObservingVariable(FPSPropertyChangedDynamic OnChanged);
+
+	//Waiting
+	/**
+	 * Resumes once Target's numeric variable named VarName satisfies (Value Op Operand). Replaces a Delay loop around a getter:
+	 * every waiting node is checked together once per tick by FPSConditions. Never resumes if the variable is missing or not a number,
+	 * or if Target is destroyed first.
+	 */
+	UFUNCTION(BlueprintCallable, meta = (Latent, LatentInfo = "LatentInfo", WorldContext = "WorldContextObject"), Category = "nfPopulationSystem")
+		static void WaitUntilValueByName(UObject* WorldContextObject, UObject* Target, FName VarName, EPSCompareOp Op, float Operand, FLatentActionInfo LatentInfo);
+
+	//Bulk operations
+	/** Applies Op to the float named VarName on every target in one pass. Returns how many targets were updated. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 ApplyFloatOpByName(const TArray<UObject*>& Targets, FName VarName, EPSBulkOp Op, float A, float B);
+
+	/** Applies Op to the int named VarName on every target in one pass. Lerp is not supported for ints. Returns how many targets were updated. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 ApplyIntOpByName(const TArray<UObject*>& Targets, FName VarName, EPSBulkOp Op, int A, int B);
+
+	/**
+	 * Sets VarName on every target to Value, written the way it would be typed in a details panel (e.g. "1.5", "true", "(X=1,Y=2,Z=3)").
+	 * Value is parsed once per variable type rather than once per target. Returns how many targets were updated.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 SetValuesFromStringByName(const TArray<UObject*>& Targets, FName VarName, const FString& Value);
+
+	//Queries
+	/** Returns the targets whose float named VarName satisfies (Value Op Operand). Targets without the variable never match. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 QueryObjectsByFloat(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, float Operand, TArray<UObject*>& OutMatches);
+
+	/** Same as QueryObjectsByFloat, but returns the indices of the matching targets. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 QueryIndicesByFloat(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, float Operand, TArray<int32>& OutIndices);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 QueryObjectsByInt(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, int Operand, TArray<UObject*>& OutMatches);
+
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 QueryIndicesByInt(const TArray<UObject*>& Targets, FName VarName, EPSCompareOp Op, int Operand, TArray<int32>& OutIndices);
+
+	//Sorting
+	/**
+	 * Sorts Targets by the numeric variable named VarName (float, double, int, int64 or byte). The sort is stable, and integer variables are compared exactly rather than as doubles.
+	 * Targets without the variable keep their relative order and are moved to the end. Returns how many targets had the variable.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 SortObjectsByName(UPARAM(ref) TArray<UObject*>& Targets, FName VarName, bool bDescending);
+
+	//Reductions
+	/** Sum, min/max (with the index of the target holding them), mean and variance of the numeric variable named VarName. Returns false if no target had it. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static bool ReduceByName(const TArray<UObject*>& Targets, FName VarName, FPSReductionResult& OutResult);
+
+	/** Counts the values of the numeric variable named VarName into NumBuckets equal buckets over [Min, Max). Values outside the range land in the first/last bucket, NaNs are skipped. Returns how many values were counted. */
+	UFUNCTION(BlueprintCallable, Category = "nfPopulationSystem")
+		static int32 HistogramByName(const TArray<UObject*>& Targets, FName VarName, float Min, float Max, int32 NumBuckets, TArray<int32>& OutBuckets);
+
+	//Custom thunks
+	//The typed accessors read their operands straight off the VM stack, taking inputs by reference instead of copying them into locals,
+	//and write results straight into the caller's out parameters.
+	DECLARE_FUNCTION(execSetFloatByName);
+	DECLARE_FUNCTION(execSetIntByName);
+	DECLARE_FUNCTION(execSetInt64ByName);
+	DECLARE_FUNCTION(execSetBoolByName);
+	DECLARE_FUNCTION(execSetNameByName);
+	DECLARE_FUNCTION(execSetObjectByName);
+	DECLARE_FUNCTION(execSetByteByName);
+	DECLARE_FUNCTION(execSetStringByName);
+	DECLARE_FUNCTION(execSetTextByName);
+	DECLARE_FUNCTION(execGetFloatByName);
+	DECLARE_FUNCTION(execGetIntByName);
+	DECLARE_FUNCTION(execGetInt64ByName);
+	DECLARE_FUNCTION(execGetBoolByName);
+	DECLARE_FUNCTION(execGetNameByName);
+	DECLARE_FUNCTION(execGetObjectByName);
+	DECLARE_FUNCTION(execGetByteByName);
+	DECLARE_FUNCTION(execGetStringByName);
+	DECLARE_FUNCTION(execGetTextByName);
+
+	DECLARE_FUNCTION(execSetFloatByNameCached);
+	DECLARE_FUNCTION(execSetIntByNameCached);
+	DECLARE_FUNCTION(execSetInt64ByNameCached);
+	DECLARE_FUNCTION(execSetBoolByNameCached);
+	DECLARE_FUNCTION(execSetNameByNameCached);
+	DECLARE_FUNCTION(execSetObjectByNameCached);
+	DECLARE_FUNCTION(execSetByteByNameCached);
+	DECLARE_FUNCTION(execSetStringByNameCached);
+	DECLARE_FUNCTION(execSetTextByNameCached);
+	DECLARE_FUNCTION(execGetFloatByNameCached);
+	DECLARE_FUNCTION(execGetIntByNameCached);
+	DECLARE_FUNCTION(execGetInt64ByNameCached);
+	DECLARE_FUNCTION(execGetBoolByNameCached);
+	DECLARE_FUNCTION(execGetNameByNameCached);
+	DECLARE_FUNCTION(execGetObjectByNameCached);
+	DECLARE_FUNCTION(execGetByteByNameCached);
+	DECLARE_FUNCTION(execGetStringByNameCached);
+	DECLARE_FUNCTION(execGetTextByNameCached);
+
+	DECLARE_FUNCTION(execGetValueByNameCached);
+	DECLARE_FUNCTION(execCopyStructToObjectByNames);
+	DECLARE_FUNCTION(execCopyObjectToStructByNames);
+
 };
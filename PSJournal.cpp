@@ -0,0 +1,436 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSJournal.h"
+
+#include "PSPropertyCache.h"
+
+#include "Algo/StableSort.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/Atomic.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UnrealType.h"
+
+TAtomic<bool> FPSJournal::bEnabled(false);
+
+namespace
+{
+	struct FPSJournalRing
+	{
+		explicit FPSJournalRing(int32 InCapacity)
+			: Head(0)
+			, Tail(0)
+		{
+			Entries.SetNumUninitialized(FMath::Max(InCapacity, 1));
+		}
+
+		void Add(const FPSJournalEntry& Entry)
+		{
+			// Only this ring's thread writes Head. The entry goes in first, so Collect never sees a count that includes a half written entry.
+			const uint64 Index = Head.Load(EMemoryOrder::Relaxed);
+			Entries[Index % Entries.Num()] = Entry;
+			Head.Store(Index + 1);
+		}
+
+		uint32 FindPropertyId(FName VarName)
+		{
+			if (const uint32* PropertyId = PropertyIds.Find(VarName))
+			{
+				return *PropertyId;
+			}
+			return PropertyIds.Add(VarName, FPSJournal::InternPropertyId(VarName));
+		}
+
+		TArray<FPSJournalEntry> Entries;
+
+		/** Total entries ever written */
+		TAtomic<uint64> Head;
+
+		/** First entry not collected yet, only touched by Collect */
+		uint64 Tail;
+
+		/** This thread's copy of the interned ids, so recording doesn't take the id lock */
+		TMap<FName, uint32> PropertyIds;
+	};
+
+	struct FPSJournalStorage
+	{
+		FPSJournalStorage()
+			: CapacityPerThread(64 * 1024)
+		{
+		}
+
+		FCriticalSection RingsLock;
+		TArray<TUniquePtr<FPSJournalRing>> Rings;
+		int32 CapacityPerThread;
+
+		FRWLock IdLock;
+		TMap<FName, uint32> PropertyIds;
+		TArray<FName> PropertyNames;
+
+		FRWLock ValueLock;
+		TMap<FString, uint32> ValueIds;
+		TArray<FString> ValueStrings;
+	};
+
+	FPSJournalStorage& GetStorage()
+	{
+		static FPSJournalStorage Storage;
+		return Storage;
+	}
+
+	// Rings outlive their threads, so entries from finished workers can still be collected
+	FPSJournalRing& GetThreadRing()
+	{
+		static thread_local FPSJournalRing* ThreadRing = nullptr;
+		if (!ThreadRing)
+		{
+			FPSJournalStorage& Storage = GetStorage();
+			FScopeLock ScopeLock(&Storage.RingsLock);
+			Storage.Rings.Add(MakeUnique<FPSJournalRing>(Storage.CapacityPerThread));
+			ThreadRing = Storage.Rings.Last().Get();
+		}
+		return *ThreadRing;
+	}
+
+	template<typename ValueType>
+	uint64 ToBits(ValueType Value)
+	{
+		static_assert(sizeof(ValueType) <= sizeof(uint64), "Journal values are stored in 64 bits");
+		uint64 Bits = 0;
+		FMemory::Memcpy(&Bits, &Value, sizeof(ValueType));
+		return Bits;
+	}
+
+	template<typename ValueType>
+	ValueType FromBits(uint64 Bits)
+	{
+		ValueType Value;
+		FMemory::Memcpy(&Value, &Bits, sizeof(ValueType));
+		return Value;
+	}
+
+	UObject* ResolveObject(uint32 ObjectId, const TMap<uint32, UObject*>* ObjectRemap)
+	{
+		if (ObjectRemap)
+		{
+			if (UObject* const* Remapped = ObjectRemap->Find(ObjectId))
+			{
+				return *Remapped;
+			}
+		}
+
+		FUObjectItem* Item = GUObjectArray.IndexToObject(ObjectId);
+		return (Item && Item->Object) ? static_cast<UObject*>(Item->Object) : nullptr;
+	}
+}
+
+void FPSJournal::SetEnabled(bool bInEnabled)
+{
+	bEnabled = bInEnabled;
+}
+
+void FPSJournal::SetCapacityPerThread(int32 InCapacity)
+{
+	FPSJournalStorage& Storage = GetStorage();
+	FScopeLock ScopeLock(&Storage.RingsLock);
+	Storage.CapacityPerThread = InCapacity;
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, float OldValue, float NewValue)
+{
+	Append(Object, VarName, EPSJournalValueType::Float, ToBits(OldValue), ToBits(NewValue));
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, int32 OldValue, int32 NewValue)
+{
+	Append(Object, VarName, EPSJournalValueType::Int, ToBits(OldValue), ToBits(NewValue));
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, int64 OldValue, int64 NewValue)
+{
+	Append(Object, VarName, EPSJournalValueType::Int64, ToBits(OldValue), ToBits(NewValue));
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, bool OldValue, bool NewValue)
+{
+	Append(Object, VarName, EPSJournalValueType::Bool, OldValue ? 1 : 0, NewValue ? 1 : 0);
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, uint8 OldValue, uint8 NewValue)
+{
+	Append(Object, VarName, EPSJournalValueType::Byte, OldValue, NewValue);
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, const UObject* OldValue, const UObject* NewValue)
+{
+	// Ids are 32 bit, so an all ones 64 bit value can stand for null
+	Append(Object, VarName, EPSJournalValueType::Object, OldValue ? OldValue->GetUniqueID() : MAX_uint64, NewValue ? NewValue->GetUniqueID() : MAX_uint64);
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, FName OldValue, FName NewValue)
+{
+	Append(Object, VarName, EPSJournalValueType::Name, InternValueString(OldValue.ToString()), InternValueString(NewValue.ToString()));
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, const FString& OldValue, const FString& NewValue)
+{
+	Append(Object, VarName, EPSJournalValueType::String, InternValueString(OldValue), InternValueString(NewValue));
+}
+
+void FPSJournal::Record(const UObject* Object, FName VarName, const FText& OldValue, const FText& NewValue)
+{
+	// Exported rather than displayed, so replay gets back the same localized text and not just its current string
+	FString OldString;
+	FString NewString;
+	FTextStringHelper::WriteToBuffer(OldString, OldValue);
+	FTextStringHelper::WriteToBuffer(NewString, NewValue);
+	Append(Object, VarName, EPSJournalValueType::Text, InternValueString(OldString), InternValueString(NewString));
+}
+
+void FPSJournal::RecordProperty(const UObject* Object, const UProperty* Property, const void* OldAddress, const void* NewAddress)
+{
+	const FName VarName = Property->GetFName();
+
+	if (const UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+	{
+		Record(Object, VarName, BoolProperty->GetPropertyValue(OldAddress), BoolProperty->GetPropertyValue(NewAddress));
+	}
+	else if (const UFloatProperty* FloatProperty = Cast<UFloatProperty>(Property))
+	{
+		Record(Object, VarName, FloatProperty->GetPropertyValue(OldAddress), FloatProperty->GetPropertyValue(NewAddress));
+	}
+	else if (const UIntProperty* IntProperty = Cast<UIntProperty>(Property))
+	{
+		Record(Object, VarName, (int32)IntProperty->GetPropertyValue(OldAddress), (int32)IntProperty->GetPropertyValue(NewAddress));
+	}
+	else if (const UInt64Property* Int64Property = Cast<UInt64Property>(Property))
+	{
+		Record(Object, VarName, (int64)Int64Property->GetPropertyValue(OldAddress), (int64)Int64Property->GetPropertyValue(NewAddress));
+	}
+	else if (const UByteProperty* ByteProperty = Cast<UByteProperty>(Property))
+	{
+		Record(Object, VarName, ByteProperty->GetPropertyValue(OldAddress), ByteProperty->GetPropertyValue(NewAddress));
+	}
+	else if (const UObjectProperty* ObjectProperty = Cast<UObjectProperty>(Property))
+	{
+		Record(Object, VarName, (const UObject*)ObjectProperty->GetObjectPropertyValue(OldAddress), (const UObject*)ObjectProperty->GetObjectPropertyValue(NewAddress));
+	}
+	else if (const UNameProperty* NameProperty = Cast<UNameProperty>(Property))
+	{
+		Record(Object, VarName, NameProperty->GetPropertyValue(OldAddress), NameProperty->GetPropertyValue(NewAddress));
+	}
+	else if (const UStrProperty* StrProperty = Cast<UStrProperty>(Property))
+	{
+		Record(Object, VarName, StrProperty->GetPropertyValue(OldAddress), StrProperty->GetPropertyValue(NewAddress));
+	}
+	else if (const UTextProperty* TextProperty = Cast<UTextProperty>(Property))
+	{
+		Record(Object, VarName, TextProperty->GetPropertyValue(OldAddress), TextProperty->GetPropertyValue(NewAddress));
+	}
+	else
+	{
+		FString OldString;
+		FString NewString;
+		Property->ExportTextItem(OldString, OldAddress, nullptr, nullptr, PPF_None);
+		Property->ExportTextItem(NewString, NewAddress, nullptr, nullptr, PPF_None);
+		Append(Object, VarName, EPSJournalValueType::Exported, InternValueString(OldString), InternValueString(NewString));
+	}
+}
+
+void FPSJournal::Append(const UObject* Object, FName VarName, EPSJournalValueType ValueType, uint64 OldValue, uint64 NewValue)
+{
+	FPSJournalEntry Entry;
+	Entry.Timestamp = FPlatformTime::Cycles64();
+	Entry.OldValue = OldValue;
+	Entry.NewValue = NewValue;
+	Entry.ObjectId = Object->GetUniqueID();
+	Entry.ValueType = ValueType;
+
+	FPSJournalRing& Ring = GetThreadRing();
+	Entry.PropertyId = Ring.FindPropertyId(VarName);
+	Ring.Add(Entry);
+}
+
+void FPSJournal::Collect(TArray<FPSJournalEntry>& OutEntries)
+{
+	FPSJournalStorage& Storage = GetStorage();
+	FScopeLock ScopeLock(&Storage.RingsLock);
+
+	for (const TUniquePtr<FPSJournalRing>& Ring : Storage.Rings)
+	{
+		const uint64 Capacity = Ring->Entries.Num();
+		const uint64 Head = Ring->Head.Load();
+		const uint64 First = FMath::Max(Ring->Tail, Head > Capacity ? Head - Capacity : 0);
+
+		const int32 FirstOut = OutEntries.Num();
+		for (uint64 Index = First; Index < Head; ++Index)
+		{
+			OutEntries.Add(Ring->Entries[Index % Capacity]);
+		}
+
+		// The ring's thread may have kept recording while we copied. Entries it lapped in the meantime (including the slot it
+		// may be writing right now) could be torn, so they are dropped as if they had been overwritten before the copy. The barrier
+		// keeps the copy's loads from moving past the reload of Head, which would let a torn entry through.
+		FPlatformMisc::MemoryBarrier();
+		const uint64 HeadAfter = Ring->Head.Load();
+		const uint64 FirstIntact = HeadAfter + 1 > Capacity ? HeadAfter + 1 - Capacity : 0;
+		if (FirstIntact > First)
+		{
+			OutEntries.RemoveAt(FirstOut, (int32)FMath::Min(FirstIntact - First, Head - First), false);
+		}
+
+		Ring->Tail = Head;
+	}
+
+	// Stable, so writes from one thread that share a timestamp keep the order they were made in
+	Algo::StableSort(OutEntries, [](const FPSJournalEntry& A, const FPSJournalEntry& B) { return A.Timestamp < B.Timestamp; });
+}
+
+int32 FPSJournal::Replay(const TArray<FPSJournalEntry>& Entries, const TMap<uint32, UObject*>* ObjectRemap)
+{
+	int32 NumApplied = 0;
+
+	for (const FPSJournalEntry& Entry : Entries)
+	{
+		UObject* Object = ResolveObject(Entry.ObjectId, ObjectRemap);
+		if (!Object)
+		{
+			continue;
+		}
+
+		UProperty* Property = FPSPropertyCache::FindProperty(Object->GetClass(), GetPropertyName(Entry.PropertyId));
+		if (!Property)
+		{
+			continue;
+		}
+
+		void* Address = Property->ContainerPtrToValuePtr<void>(Object);
+
+		if (Entry.ValueType == EPSJournalValueType::Bool)
+		{
+			if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+			{
+				BoolProperty->SetPropertyValue(Address, Entry.NewValue != 0);
+				++NumApplied;
+			}
+		}
+		else if (Entry.ValueType == EPSJournalValueType::Object)
+		{
+			if (UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
+			{
+				ObjectProperty->SetObjectPropertyValue(Address, Entry.NewValue != MAX_uint64 ? ResolveObject((uint32)Entry.NewValue, ObjectRemap) : nullptr);
+				++NumApplied;
+			}
+		}
+		else if (Entry.ValueType == EPSJournalValueType::Name)
+		{
+			if (UNameProperty* NameProperty = Cast<UNameProperty>(Property))
+			{
+				NameProperty->SetPropertyValue(Address, FName(*GetValueString(Entry.NewValue)));
+				++NumApplied;
+			}
+		}
+		else if (Entry.ValueType == EPSJournalValueType::String)
+		{
+			if (UStrProperty* StrProperty = Cast<UStrProperty>(Property))
+			{
+				StrProperty->SetPropertyValue(Address, GetValueString(Entry.NewValue));
+				++NumApplied;
+			}
+		}
+		else if (Entry.ValueType == EPSJournalValueType::Text)
+		{
+			FText Text;
+			UTextProperty* TextProperty = Cast<UTextProperty>(Property);
+			if (TextProperty && FTextStringHelper::ReadFromBuffer(*GetValueString(Entry.NewValue), Text))
+			{
+				TextProperty->SetPropertyValue(Address, Text);
+				++NumApplied;
+			}
+		}
+		else if (Entry.ValueType == EPSJournalValueType::Exported)
+		{
+			if (Property->ImportText(*GetValueString(Entry.NewValue), Address, PPF_None, Object) != nullptr)
+			{
+				++NumApplied;
+			}
+		}
+		else if (UNumericProperty* NumericProperty = Cast<UNumericProperty>(Property))
+		{
+			switch (Entry.ValueType)
+			{
+			case EPSJournalValueType::Float:	NumericProperty->SetFloatingPointPropertyValue(Address, (double)FromBits<float>(Entry.NewValue)); break;
+			case EPSJournalValueType::Int:		NumericProperty->SetIntPropertyValue(Address, (int64)FromBits<int32>(Entry.NewValue)); break;
+			case EPSJournalValueType::Int64:	NumericProperty->SetIntPropertyValue(Address, FromBits<int64>(Entry.NewValue)); break;
+			case EPSJournalValueType::Byte:		NumericProperty->SetIntPropertyValue(Address, (uint64)FromBits<uint8>(Entry.NewValue)); break;
+			default: continue;
+			}
+			++NumApplied;
+		}
+	}
+
+	return NumApplied;
+}
+
+uint32 FPSJournal::InternPropertyId(FName VarName)
+{
+	FPSJournalStorage& Storage = GetStorage();
+
+	{
+		FRWScopeLock ScopeLock(Storage.IdLock, SLT_ReadOnly);
+		if (const uint32* PropertyId = Storage.PropertyIds.Find(VarName))
+		{
+			return *PropertyId;
+		}
+	}
+
+	FRWScopeLock ScopeLock(Storage.IdLock, SLT_Write);
+	if (const uint32* PropertyId = Storage.PropertyIds.Find(VarName))
+	{
+		return *PropertyId;
+	}
+
+	const uint32 NewId = Storage.PropertyNames.Add(VarName);
+	Storage.PropertyIds.Add(VarName, NewId);
+	return NewId;
+}
+
+FName FPSJournal::GetPropertyName(uint32 PropertyId)
+{
+	FPSJournalStorage& Storage = GetStorage();
+	FRWScopeLock ScopeLock(Storage.IdLock, SLT_ReadOnly);
+	return Storage.PropertyNames.IsValidIndex(PropertyId) ? Storage.PropertyNames[PropertyId] : NAME_None;
+}
+
+uint64 FPSJournal::InternValueString(const FString& Value)
+{
+	FPSJournalStorage& Storage = GetStorage();
+
+	{
+		FRWScopeLock ScopeLock(Storage.ValueLock, SLT_ReadOnly);
+		if (const uint32* ValueId = Storage.ValueIds.Find(Value))
+		{
+			return *ValueId;
+		}
+	}
+
+	FRWScopeLock ScopeLock(Storage.ValueLock, SLT_Write);
+	if (const uint32* ValueId = Storage.ValueIds.Find(Value))
+	{
+		return *ValueId;
+	}
+
+	const uint32 NewId = Storage.ValueStrings.Add(Value);
+	Storage.ValueIds.Add(Value, NewId);
+	return NewId;
+}
+
+FString FPSJournal::GetValueString(uint64 ValueId)
+{
+	FPSJournalStorage& Storage = GetStorage();
+	FRWScopeLock ScopeLock(Storage.ValueLock, SLT_ReadOnly);
+	return ValueId < (uint64)Storage.ValueStrings.Num() ? Storage.ValueStrings[(int32)ValueId] : FString();
+}
@@ -0,0 +1,93 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+class UProperty;
+
+/** Type of the value stored in a journal entry. */
+enum class EPSJournalValueType : uint8
+{
+	Float,
+	Int,
+	Int64,
+	Bool,
+	Byte,
+	Object,
+	Name,
+	String,
+	Text,
+	/** Any other type, as its exported text */
+	Exported
+};
+
+/** One Set*ByName call. Values are stored as raw bits, objects as their unique id, everything else as an id from the journal's string table. */
+struct FPSJournalEntry
+{
+	uint64 Timestamp;
+	uint64 OldValue;
+	uint64 NewValue;
+	uint32 ObjectId;
+	uint32 PropertyId;
+	EPSJournalValueType ValueType;
+};
+
+/**
+ * Opt-in journal of every write made through the single variable UPSData setters (Set*ByName, Set*ByStringName and SetValueByName)
+ * and by FPSColumnFile loads, for tracking down which write made a simulation diverge.
+ * Each thread records into its own fixed size ring buffer and keeps its own copy of the property ids, so recording numbers, bools and
+ * objects only takes a lock the first time a thread records, and the first time it records each variable. Names, strings, texts and
+ * other values are kept in a shared string table, which takes a lock per write and keeps every distinct value until the session ends.
+ * Once a buffer is full the oldest entries are overwritten.
+ * Collect() may run while other threads record, entries they overwrite during the collection are dropped. Replay() writes to the objects,
+ * so call it while nothing else does, e.g. from the game thread between ticks.
+ */
+struct NFPOPULATIONSYSTEM_API FPSJournal
+{
+	static void SetEnabled(bool bInEnabled);
+	static FORCEINLINE bool IsEnabled() { return bEnabled.Load(EMemoryOrder::Relaxed); }
+
+	/** Entries each thread keeps. Only affects buffers created after the call. */
+	static void SetCapacityPerThread(int32 InCapacity);
+
+	static void Record(const UObject* Object, FName VarName, float OldValue, float NewValue);
+	static void Record(const UObject* Object, FName VarName, int32 OldValue, int32 NewValue);
+	static void Record(const UObject* Object, FName VarName, int64 OldValue, int64 NewValue);
+	static void Record(const UObject* Object, FName VarName, bool OldValue, bool NewValue);
+	static void Record(const UObject* Object, FName VarName, uint8 OldValue, uint8 NewValue);
+	static void Record(const UObject* Object, FName VarName, const UObject* OldValue, const UObject* NewValue);
+	static void Record(const UObject* Object, FName VarName, FName OldValue, FName NewValue);
+	static void Record(const UObject* Object, FName VarName, const FString& OldValue, const FString& NewValue);
+	static void Record(const UObject* Object, FName VarName, const FText& OldValue, const FText& NewValue);
+
+	/** Records a write of Property from the value at OldAddress to the one at NewAddress, as whichever entry type fits the property. */
+	static void RecordProperty(const UObject* Object, const UProperty* Property, const void* OldAddress, const void* NewAddress);
+
+	/** Moves every thread's entries into OutEntries, ordered by time. */
+	static void Collect(TArray<FPSJournalEntry>& OutEntries);
+
+	/**
+	 * Writes the new value of each entry back, in order. Run it on state restored to the point the journal started from.
+	 * Objects are looked up by id, through ObjectRemap first when given (for restored objects that got new ids).
+	 *
+	 * @return	How many entries were applied.
+	 */
+	static int32 Replay(const TArray<FPSJournalEntry>& Entries, const TMap<uint32, UObject*>* ObjectRemap = nullptr);
+
+	/** Small stable id for VarName, the same for the whole session. */
+	static uint32 InternPropertyId(FName VarName);
+	static FName GetPropertyName(uint32 PropertyId);
+
+	/** The string a Name, String, Text or Exported entry value stands for. */
+	static FString GetValueString(uint64 ValueId);
+
+private:
+
+	static void Append(const UObject* Object, FName VarName, EPSJournalValueType ValueType, uint64 OldValue, uint64 NewValue);
+
+	static uint64 InternValueString(const FString& Value);
+
+	static TAtomic<bool> bEnabled;
+};
@@ -0,0 +1,360 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSJsonExport.h"
+
+#include "PSPropertyCache.h"
+
+#include "HAL/FileManager.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	// Output going to an archive is handed over in blocks of about this size
+	const int32 FlushSize = 64 * 1024;
+
+	/** How one requested variable is read from one class. */
+	struct FExportColumn
+	{
+		/** Index into the requested names, for the key */
+		int32 VarIndex;
+
+		UProperty* Property;
+
+		/** Kind is None unless the variable is a number (or an enum) */
+		FPSNumericAccess Numeric;
+	};
+
+	class FPSJsonWriter
+	{
+	public:
+
+		FPSJsonWriter(TArray<uint8>& InBuffer, FArchive* InArchive)
+			: Buffer(InBuffer)
+			, Archive(InArchive)
+		{
+		}
+
+		void Write(const ANSICHAR* Text, int32 Len)
+		{
+			Buffer.Append(reinterpret_cast<const uint8*>(Text), Len);
+			FlushIfFull();
+		}
+
+		void Write(const ANSICHAR* Text)
+		{
+			Write(Text, FCStringAnsi::Strlen(Text));
+		}
+
+		void Write(ANSICHAR Char)
+		{
+			Buffer.Add((uint8)Char);
+		}
+
+		void WriteInt(int64 Value)
+		{
+			// Through uint64, so the lowest int64 has a magnitude to print
+			const bool bNegative = Value < 0;
+			WriteDigits(bNegative ? 0 - (uint64)Value : (uint64)Value, bNegative);
+		}
+
+		void WriteUInt(uint64 Value)
+		{
+			WriteDigits(Value, false);
+		}
+
+		/** 9 significant digits round trip a float, 17 a double. */
+		void WriteDouble(double Value, bool bSinglePrecision)
+		{
+			if (!FMath::IsFinite(Value))
+			{
+				Write("null", 4);
+				return;
+			}
+
+			ANSICHAR Digits[32];
+			const int32 Len = FCStringAnsi::Sprintf(Digits, bSinglePrecision ? "%.9g" : "%.17g", Value);
+			Write(Digits, Len);
+		}
+
+		/** Quotes and escapes Text, which is converted to UTF-8 on the way. */
+		void WriteString(const TCHAR* Text, int32 Len)
+		{
+			const FTCHARToUTF8 Converter(Text, Len);
+			const ANSICHAR* Utf8 = Converter.Get();
+			const int32 Utf8Len = Converter.Length();
+
+			Write('"');
+
+			int32 RunStart = 0;
+			for (int32 Index = 0; Index < Utf8Len; ++Index)
+			{
+				const uint8 Char = (uint8)Utf8[Index];
+				if (Char >= 0x20 && Char != '"' && Char != '\\')
+				{
+					continue;
+				}
+
+				// Everything up to here needs no escaping
+				Buffer.Append(reinterpret_cast<const uint8*>(Utf8 + RunStart), Index - RunStart);
+				RunStart = Index + 1;
+
+				switch (Char)
+				{
+				case '"':	Write("\\\"", 2); break;
+				case '\\':	Write("\\\\", 2); break;
+				case '\n':	Write("\\n", 2); break;
+				case '\r':	Write("\\r", 2); break;
+				case '\t':	Write("\\t", 2); break;
+				case '\b':	Write("\\b", 2); break;
+				case '\f':	Write("\\f", 2); break;
+				default:
+				{
+					static const ANSICHAR HexDigits[] = "0123456789abcdef";
+					const ANSICHAR Escaped[] = { '\\', 'u', '0', '0', HexDigits[Char >> 4], HexDigits[Char & 0xF] };
+					Write(Escaped, 6);
+					break;
+				}
+				}
+			}
+			Buffer.Append(reinterpret_cast<const uint8*>(Utf8 + RunStart), Utf8Len - RunStart);
+
+			Write('"');
+			FlushIfFull();
+		}
+
+		void WriteString(const FString& Text)
+		{
+			WriteString(*Text, Text.Len());
+		}
+
+		void Flush()
+		{
+			if (Archive && Buffer.Num() > 0)
+			{
+				Archive->Serialize(Buffer.GetData(), Buffer.Num());
+				Buffer.Reset();
+			}
+		}
+
+	private:
+
+		void WriteDigits(uint64 Magnitude, bool bNegative)
+		{
+			ANSICHAR Digits[24];
+			int32 Pos = ARRAY_COUNT(Digits);
+			do
+			{
+				Digits[--Pos] = (ANSICHAR)('0' + Magnitude % 10);
+				Magnitude /= 10;
+			} while (Magnitude > 0);
+
+			if (bNegative)
+			{
+				Digits[--Pos] = '-';
+			}
+
+			Write(Digits + Pos, ARRAY_COUNT(Digits) - Pos);
+		}
+
+		void FlushIfFull()
+		{
+			if (Archive && Buffer.Num() >= FlushSize)
+			{
+				Flush();
+			}
+		}
+
+		TArray<uint8>& Buffer;
+		FArchive* Archive;
+	};
+
+	bool IsUnsigned(EPSNumericKind Kind)
+	{
+		return Kind == EPSNumericKind::UInt8 || Kind == EPSNumericKind::UInt16 || Kind == EPSNumericKind::UInt32 || Kind == EPSNumericKind::UInt64;
+	}
+
+	void BuildColumns(const UClass* Class, const TArray<FName>& VarNames, TArray<FExportColumn>& OutColumns)
+	{
+		for (int32 VarIndex = 0; VarIndex < VarNames.Num(); ++VarIndex)
+		{
+			UProperty* Property = FPSPropertyCache::FindProperty(Class, VarNames[VarIndex]);
+			if (!Property || Property->ArrayDim != 1)
+			{
+				continue;
+			}
+
+			FExportColumn& Column = OutColumns.AddDefaulted_GetRef();
+			Column.VarIndex = VarIndex;
+			Column.Property = Property;
+			FPSPropertyCache::FindNumeric(Class, VarNames[VarIndex], Column.Numeric);
+		}
+	}
+
+	void WriteValue(FPSJsonWriter& Writer, const UObject* Target, const FExportColumn& Column, FString& Scratch)
+	{
+		switch (Column.Numeric.Kind)
+		{
+		case EPSNumericKind::None:
+			break;
+		case EPSNumericKind::Float:
+			Writer.WriteDouble(Column.Numeric.Read<double>(Target), true);
+			return;
+		case EPSNumericKind::Double:
+			Writer.WriteDouble(Column.Numeric.Read<double>(Target), false);
+			return;
+		default:
+			if (IsUnsigned(Column.Numeric.Kind))
+			{
+				Writer.WriteUInt(Column.Numeric.Read<uint64>(Target));
+			}
+			else
+			{
+				Writer.WriteInt(Column.Numeric.Read<int64>(Target));
+			}
+			return;
+		}
+
+		const UProperty* Property = Column.Property;
+		const void* Address = Property->ContainerPtrToValuePtr<void>(Target);
+
+		if (const UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+		{
+			Writer.Write(BoolProperty->GetPropertyValue(Address) ? "true" : "false");
+		}
+		else if (const UStrProperty* StrProperty = Cast<UStrProperty>(Property))
+		{
+			Writer.WriteString(StrProperty->GetPropertyValue(Address));
+		}
+		else if (const UNameProperty* NameProperty = Cast<UNameProperty>(Property))
+		{
+			NameProperty->GetPropertyValue(Address).ToString(Scratch);
+			Writer.WriteString(Scratch);
+		}
+		else if (const UTextProperty* TextProperty = Cast<UTextProperty>(Property))
+		{
+			Writer.WriteString(TextProperty->GetPropertyValue(Address).ToString());
+		}
+		else if (const UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
+		{
+			const UObject* Object = ObjectProperty->GetObjectPropertyValue(Address);
+			if (Object)
+			{
+				Scratch.Reset();
+				Object->GetPathName(nullptr, Scratch);
+				Writer.WriteString(Scratch);
+			}
+			else
+			{
+				Writer.Write("null", 4);
+			}
+		}
+		else
+		{
+			Scratch.Reset();
+			Property->ExportTextItem(Scratch, Address, nullptr, const_cast<UObject*>(Target), PPF_None);
+			Writer.WriteString(Scratch);
+		}
+	}
+
+	int32 Export(FPSJsonWriter& Writer, const TArray<UObject*>& Targets, const TArray<FName>& VarNames)
+	{
+		// "Name": for every requested variable, escaped once
+		TArray<TArray<uint8>> Keys;
+		Keys.SetNum(VarNames.Num());
+		for (int32 VarIndex = 0; VarIndex < VarNames.Num(); ++VarIndex)
+		{
+			FPSJsonWriter KeyWriter(Keys[VarIndex], nullptr);
+			KeyWriter.WriteString(VarNames[VarIndex].ToString());
+			KeyWriter.Write(':');
+		}
+
+		TMap<const UClass*, TArray<FExportColumn>> ClassColumns;
+		const UClass* LastClass = nullptr;
+		const TArray<FExportColumn>* LastColumns = nullptr;
+		FString Scratch;
+		int32 NumWritten = 0;
+
+		Writer.Write("[\n", 2);
+
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			const UObject* Target = Targets[TargetIndex];
+			if (!Target)
+			{
+				Writer.Write("null", 4);
+			}
+			else
+			{
+				const UClass* Class = Target->GetClass();
+				if (Class != LastClass)
+				{
+					TArray<FExportColumn>* Columns = ClassColumns.Find(Class);
+					if (!Columns)
+					{
+						Columns = &ClassColumns.Add(Class);
+						BuildColumns(Class, VarNames, *Columns);
+					}
+					LastClass = Class;
+					LastColumns = Columns;
+				}
+
+				Writer.Write('{');
+				for (int32 ColumnIndex = 0; ColumnIndex < LastColumns->Num(); ++ColumnIndex)
+				{
+					const FExportColumn& Column = (*LastColumns)[ColumnIndex];
+					if (ColumnIndex > 0)
+					{
+						Writer.Write(',');
+					}
+
+					const TArray<uint8>& Key = Keys[Column.VarIndex];
+					Writer.Write(reinterpret_cast<const ANSICHAR*>(Key.GetData()), Key.Num());
+					WriteValue(Writer, Target, Column, Scratch);
+				}
+				Writer.Write('}');
+
+				++NumWritten;
+			}
+
+			if (TargetIndex + 1 < Targets.Num())
+			{
+				Writer.Write(',');
+			}
+			Writer.Write('\n');
+		}
+
+		Writer.Write(']');
+		Writer.Flush();
+
+		return NumWritten;
+	}
+}
+
+int32 FPSJsonExport::ExportToBuffer(const TArray<UObject*>& Targets, const TArray<FName>& VarNames, TArray<uint8>& OutBuffer)
+{
+	FPSJsonWriter Writer(OutBuffer, nullptr);
+	return Export(Writer, Targets, VarNames);
+}
+
+int32 FPSJsonExport::ExportToArchive(FArchive& Ar, const TArray<UObject*>& Targets, const TArray<FName>& VarNames)
+{
+	TArray<uint8> Buffer;
+	Buffer.Reserve(FlushSize * 2);
+
+	FPSJsonWriter Writer(Buffer, &Ar);
+	return Export(Writer, Targets, VarNames);
+}
+
+bool FPSJsonExport::ExportToFile(const FString& Filename, const TArray<UObject*>& Targets, const TArray<FName>& VarNames)
+{
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!FileWriter)
+	{
+		return false;
+	}
+
+	ExportToArchive(*FileWriter, Targets, VarNames);
+	return FileWriter->Close();
+}
@@ -0,0 +1,35 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Streaming JSON export of named variables for a whole population, with no JSON object tree in between.
+ *
+ * Writes one array with an object per target, in order, each holding the requested variables the target's class has:
+ *     [
+ *     {"Health":100,"Speed":4.5,"Squad":"Alpha"},
+ *     null,
+ *     ...
+ *     ]
+ * Null targets are written as null. Variables are resolved once per class and keys are escaped once for the whole export.
+ * Numbers are formatted straight into the output as UTF-8 (floats round trip, NaN and infinity become null), enums are written as
+ * their numeric value, bools as true/false, strings, names and texts as JSON strings, objects as their path name or null.
+ * Anything else (structs, containers) is written as a string holding its exported text. Only single values are exported.
+ */
+struct NFPOPULATIONSYSTEM_API FPSJsonExport
+{
+	/**
+	 * Appends the export to OutBuffer as UTF-8.
+	 *
+	 * @return	How many targets were written as objects (not counting nulls).
+	 */
+	static int32 ExportToBuffer(const TArray<UObject*>& Targets, const TArray<FName>& VarNames, TArray<uint8>& OutBuffer);
+
+	/** Streams the export into Ar, handing it blocks of about 64 KB. */
+	static int32 ExportToArchive(FArchive& Ar, const TArray<UObject*>& Targets, const TArray<FName>& VarNames);
+
+	/** Writes the export to Filename. Returns false if the file could not be written. */
+	static bool ExportToFile(const FString& Filename, const TArray<UObject*>& Targets, const TArray<FName>& VarNames);
+};
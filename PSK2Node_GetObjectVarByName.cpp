@@ -15,8 +15,18 @@
 #include "BlueprintNodeSpawner.h"
 #include "K2Node_CallFunction.h"
 
+#include "Engine/Blueprint.h"
+#include "HAL/LowLevelMemTracker.h"
+
 #define LOCTEXT_NAMESPACE "PSK2Node_GetObjectVarByName"
 
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+DECLARE_LLM_MEMORY_STAT(TEXT("PSGetObjectVarNodes"), STAT_PSGetObjectVarNodesLLM, STATGROUP_LLMFULL);
+#define PS_GETTER_NODE_LLM_SCOPE() LLM_SCOPED_TAG_WITH_STAT(STAT_PSGetObjectVarNodesLLM, ELLMTracker::Default)
+#else
+#define PS_GETTER_NODE_LLM_SCOPE()
+#endif
+
 struct FGetGetterPinName
 {
 
@@ -59,82 +69,131 @@ namespace FSetterFunctionNames
 	static const FName TextGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetTextByName));
 	static const FName StructGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetStructByName));
 	static const FName EnumGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetEnumByName));
+
+	static const FName FloatCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetFloatByNameCached));
+	static const FName IntCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetIntByNameCached));
+	static const FName Int64CachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetInt64ByNameCached));
+	static const FName BoolCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetBoolByNameCached));
+	static const FName NameCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetNameByNameCached));
+	static const FName ObjectCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetObjectByNameCached));
+	static const FName ByteCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetByteByNameCached));
+	static const FName StringCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetStringByNameCached));
+	static const FName TextCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetTextByNameCached));
+
+	static const FName ValueCachedGetterName(GET_FUNCTION_NAME_CHECKED(UPSData, GetValueByNameCached));
 };
 
 namespace
 {
-	// Optional pin manager subclass.
-	struct FGetObjectVarOptionalPinManager : public FOptionalPinManager
+	// Same rules the optional pin manager used to apply: only Blueprint visible properties, and no non-class object references.
+	bool CanExposeProperty(UProperty* TestProperty, bool bExcludeObjectArrayProperties, bool bExcludeObjectContainerProperties)
 	{
-		FGetObjectVarOptionalPinManager(UClass* InClass, bool bExcludeObjectContainers, bool bExcludeObjectArrays)
-			:FOptionalPinManager()
+		if (!TestProperty || !TestProperty->HasAllPropertyFlags(CPF_BlueprintVisible))
 		{
-			SrcClass = InClass;
-			bExcludeObjectArrayProperties = bExcludeObjectContainers | bExcludeObjectArrays;
-			bExcludeObjectContainerProperties = bExcludeObjectContainers;
+			return false;
 		}
 
-		virtual void GetRecordDefaults(UProperty* TestProperty, FOptionalPinFromProperty& Record) const override
+		if (UArrayProperty* TestArrayProperty = Cast<UArrayProperty>(TestProperty))
 		{
-			FOptionalPinManager::GetRecordDefaults(TestProperty, Record);
-
-			// Show pin unless the property is owned by a parent class.
-			Record.bShowPin = TestProperty->GetOwnerClass() == SrcClass;
+			if (bExcludeObjectArrayProperties && TestArrayProperty->Inner)
+			{
+				TestProperty = TestArrayProperty->Inner;
+			}
 		}
-
-		virtual bool CanTreatPropertyAsOptional(UProperty* TestProperty) const override
+		else if (USetProperty* TestSetProperty = Cast<USetProperty>(TestProperty))
 		{
-			// Don't expose anything not marked BlueprintReadOnly/BlueprintReadWrite.
-			if (!TestProperty || !TestProperty->HasAllPropertyFlags(CPF_BlueprintVisible))
+			if (bExcludeObjectContainerProperties && TestSetProperty->ElementProp)
 			{
-				return false;
+				TestProperty = TestSetProperty->ElementProp;
 			}
+		}
+		else if (UMapProperty* TestMapProperty = Cast<UMapProperty>(TestProperty))
+		{
+			return !(bExcludeObjectContainerProperties
+				&& ((TestMapProperty->KeyProp && TestMapProperty->KeyProp->IsA<UObjectProperty>() && !TestMapProperty->KeyProp->IsA<UClassProperty>())
+					|| (TestMapProperty->ValueProp && TestMapProperty->ValueProp->IsA<UObjectProperty>() && !TestMapProperty->ValueProp->IsA<UClassProperty>())));
+		}
 
-			if (UArrayProperty* TestArrayProperty = Cast<UArrayProperty>(TestProperty))
-			{
-				// We only use the Inner type if the flag is set. This is done for backwards-compatibility (some BPs may already rely on the previous behavior when the property value was allowed to be exposed).
-				if (bExcludeObjectArrayProperties && TestArrayProperty->Inner)
-				{
-					TestProperty = TestArrayProperty->Inner;
-				}
-			}
-			else if (USetProperty* TestSetProperty = Cast<USetProperty>(TestProperty))
+		return !TestProperty->IsA<UObjectProperty>() || TestProperty->IsA<UClassProperty>();
+	}
+
+	/**
+	 * Rebuilds getter nodes when the Blueprint they read from changes.
+	 * Holds one OnChanged/OnCompiled subscription per Blueprint for all nodes, rather than two delegate handles and a Blueprint pointer in every node.
+	 */
+	class FPSGetterBlueprintWatcher
+	{
+	public:
+
+		static FPSGetterBlueprintWatcher& Get()
+		{
+			static FPSGetterBlueprintWatcher Watcher;
+			return Watcher;
+		}
+
+		void Watch(UBlueprint* Blueprint, UPSK2Node_GetObjectVarByName* Node)
+		{
+			PS_GETTER_NODE_LLM_SCOPE();
+
+			FWatchedBlueprint* Watched = WatchedBlueprints.Find(Blueprint);
+			if (!Watched)
 			{
-				if (bExcludeObjectContainerProperties && TestSetProperty->ElementProp)
+				// Good time to forget Blueprints that have been deleted since
+				for (auto It = WatchedBlueprints.CreateIterator(); It; ++It)
 				{
-					TestProperty = TestSetProperty->ElementProp;
+					if (!It.Key().IsValid())
+					{
+						It.RemoveCurrent();
+					}
 				}
-			}
-			else if (UMapProperty* TestMapProperty = Cast<UMapProperty>(TestProperty))
-			{
-				// Since we can't treat the key or value as read-only right now, we exclude any TMap that has a non-class UObject reference as its key or value type.
-				return !(bExcludeObjectContainerProperties
-					&& ((TestMapProperty->KeyProp && TestMapProperty->KeyProp->IsA<UObjectProperty>() && !TestMapProperty->KeyProp->IsA<UClassProperty>())
-						|| (TestMapProperty->ValueProp && TestMapProperty->ValueProp->IsA<UObjectProperty>() && !TestMapProperty->ValueProp->IsA<UClassProperty>())));
+
+				Watched = &WatchedBlueprints.Add(Blueprint);
+				Watched->OnChangedHandle = Blueprint->OnChanged().AddRaw(this, &FPSGetterBlueprintWatcher::OnBlueprintModified);
+				Watched->OnCompiledHandle = Blueprint->OnCompiled().AddRaw(this, &FPSGetterBlueprintWatcher::OnBlueprintModified);
 			}
 
-			// Don't expose object properties (except for those containing class objects).
-			// @TODO - Could potentially expose object reference values if/when we have support for 'const' input pins.
-			return !TestProperty->IsA<UObjectProperty>() || TestProperty->IsA<UClassProperty>();
+			Watched->Nodes.AddUnique(Node);
 		}
 
-		virtual void CustomizePinData(UEdGraphPin* Pin, FName SourcePropertyName, int32 ArrayIndex, UProperty* Property = nullptr) const override
+	private:
+
+		struct FWatchedBlueprint
 		{
-			check(Pin);
+			FDelegateHandle OnChangedHandle;
+			FDelegateHandle OnCompiledHandle;
+			TArray<TWeakObjectPtr<UPSK2Node_GetObjectVarByName>> Nodes;
+		};
 
-			// Move into the advanced view if the property metadata is set.
-			Pin->bAdvancedView = Property && Property->HasAnyPropertyFlags(CPF_AdvancedDisplay);
-		}
+		void OnBlueprintModified(UBlueprint* Blueprint)
+		{
+			FWatchedBlueprint* Watched = WatchedBlueprints.Find(Blueprint);
+			if (!Watched)
+			{
+				return;
+			}
 
-	private:
-		// Class type for which optional pins are being managed.
-		UClass* SrcClass;
+			// Reconstructing a node registers it again, so start from an empty list
+			TArray<TWeakObjectPtr<UPSK2Node_GetObjectVarByName>> Nodes = MoveTemp(Watched->Nodes);
+			for (const TWeakObjectPtr<UPSK2Node_GetObjectVarByName>& Node : Nodes)
+			{
+				// Nodes that were pointed at another class since they registered are simply dropped
+				UClass* InputClass = Node.IsValid() ? Node->GetInputClass() : nullptr;
+				if (InputClass && InputClass->ClassGeneratedBy == Blueprint)
+				{
+					Node->OnBlueprintClassModified(Blueprint);
+				}
+			}
 
-		// Indicates whether or not object array properties will be excluded (for backwards-compatibility).
-		bool bExcludeObjectArrayProperties;
+			Watched = WatchedBlueprints.Find(Blueprint);
+			if (Watched && Watched->Nodes.Num() == 0)
+			{
+				Blueprint->OnChanged().Remove(Watched->OnChangedHandle);
+				Blueprint->OnCompiled().Remove(Watched->OnCompiledHandle);
+				WatchedBlueprints.Remove(Blueprint);
+			}
+		}
 
-		// Indicates whether or not object container properties will be excluded (will supercede the array-specific flag when true).
-		bool bExcludeObjectContainerProperties;
+		TMap<TWeakObjectPtr<UBlueprint>, FWatchedBlueprint> WatchedBlueprints;
 	};
 
 	// Compilation handler subclass.
@@ -226,42 +285,20 @@ namespace
 	};
 }
 
-//UObject interface
-void UPSK2Node_GetObjectVarByName::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
-{
-	const FName PropertyName = (PropertyChangedEvent.Property ? PropertyChangedEvent.Property->GetFName() : NAME_None);
-
-	if (PropertyName == GET_MEMBER_NAME_CHECKED(FOptionalPinFromProperty, bShowPin))
-	{
-		UpdateShowPinForProperties();
-		FOptionalPinManager::EvaluateOldShownPins(ShowPinForProperties, OldShownPins, this);
-		GetSchema()->ReconstructNode(*this);
-	}
-
-	Super::PostEditChangeProperty(PropertyChangedEvent);
-}
-
-void UPSK2Node_GetObjectVarByName::PreEditChange(UProperty* PropertyThatWillChange)
-{
-	Super::PreEditChange(PropertyThatWillChange);
-
-	if (PropertyThatWillChange && PropertyThatWillChange->GetFName() == GET_MEMBER_NAME_CHECKED(FOptionalPinFromProperty, bShowPin))
-	{
-		UpdateShowPinForProperties();
-		FOptionalPinManager::CacheShownPins(ShowPinForProperties, OldShownPins);
-	}
-}
-//end uobject interface
-
 void UPSK2Node_GetObjectVarByName::AllocateDefaultPins()
 {
+	PS_GETTER_NODE_LLM_SCOPE();
+
 	const UEdGraphSchema_K2* K2Schema = GetDefault<UEdGraphSchema_K2>();
 
 	/*Create our pins*/
 
 	// Execution pins
-	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
-	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
+	if (!bIsPure)
+	{
+		CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
+		CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
+	}
 
 	//Input
 	UEdGraphNode::FCreatePinParams PinParams;
@@ -354,6 +391,10 @@ void UPSK2Node_GetObjectVarByName::PinConnectionListChanged(UEdGraphPin* Changed
 
 FText UPSK2Node_GetObjectVarByName::GetNodeTitle(ENodeTitleType::Type TitleType) const
 {
+	if (bIsPure)
+	{
+		return LOCTEXT("GetObjVarByNameK2Node_PureTitle", "Get Object Variable By Name (Pure)");
+	}
 	return LOCTEXT("GetObjVarByNameK2Node_Title", "Get Object Variable By Name");
 }
 
@@ -411,7 +452,14 @@ void UPSK2Node_GetObjectVarByName::ExpandNode(class FKismetCompilerContext& Comp
 
 	//UE_LOG(LogTemp, Warning, TEXT("ExpandNode[0]: Run."));
 
-	UFunction* BlueprintFunction = FindGetterFunctionByType(GetReturnValueType());
+	if (bIsPure)
+	{
+		ExpandPureNode(CompilerContext, SourceGraph);
+		return;
+	}
+
+	UFunction* CachedFunction = FindCachedGetterFunctionByType(GetReturnValueType());
+	UFunction* BlueprintFunction = CachedFunction ? CachedFunction : FindGetterFunctionByType(GetReturnValueType());
 
 	if (!BlueprintFunction)
 	{
@@ -457,6 +505,14 @@ void UPSK2Node_GetObjectVarByName::ExpandNode(class FKismetCompilerContext& Comp
 	CallFunction->AllocateDefaultPins();
 	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallFunction, this);
 
+	if (CachedFunction)
+	{
+		// In the event graph the cache lives in the ubergraph frame, which lasts as long as the object, so it keeps its entries from one
+		// event to the next. In a function it is a local that starts out empty on every call, so there it only pays off for nodes in loops.
+		UK2Node_TemporaryVariable* InlineCache = CompilerContext.SpawnInternalVariable(this, UEdGraphSchema_K2::PC_Struct, NAME_None, FPSInlineCache::StaticStruct());
+		CompilerContext.GetSchema()->TryCreateConnection(InlineCache->GetVariablePin(), CallFunction->FindPinChecked(TEXT("Cache")));
+	}
+
 	//Exec pins
 	UEdGraphPin* NodeExec = GetExecPin();
 	UEdGraphPin* NodeThen = FindPin(UEdGraphSchema_K2::PN_Then);
@@ -517,6 +573,44 @@ void UPSK2Node_GetObjectVarByName::ExpandNode(class FKismetCompilerContext& Comp
 	*/
 }
 
+void UPSK2Node_GetObjectVarByName::ExpandPureNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+	UFunction* CachedFunction = UPSData::StaticClass()->FindFunctionByName(FSetterFunctionNames::ValueCachedGetterName);
+	UEdGraphPin* ValuePin = GetReturnValuePin();
+
+	// Same check as the impure expansion gets from looking its getter up by type
+	const bool bResolved = !ResolvedPinType.PinCategory.IsNone() && ResolvedPinType.PinCategory != UEdGraphSchema_K2::PC_Wildcard;
+
+	if (!CachedFunction || !ValuePin || !bResolved)
+	{
+		CompilerContext.MessageLog.Error(*LOCTEXT("InvalidFunctionName", "The function has not been found.").ToString(), this);
+		return;
+	}
+
+	UK2Node_CallFunction* CallFunction = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+	CallFunction->SetFromFunction(CachedFunction);
+	CallFunction->AllocateDefaultPins();
+	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallFunction, this);
+
+	// The value is a wildcard until it is given the variable's type
+	UEdGraphPin* CallValuePin = CallFunction->FindPinChecked(TEXT("Value"));
+	CallValuePin->PinType = ResolvedPinType;
+
+	// The same call site cache the impure node gets, with the same lifetime. It only holds the lookup, every evaluation still reads the current value.
+	UK2Node_TemporaryVariable* InlineCache = CompilerContext.SpawnInternalVariable(this, UEdGraphSchema_K2::PC_Struct, NAME_None, FPSInlineCache::StaticStruct());
+	CompilerContext.GetSchema()->TryCreateConnection(InlineCache->GetVariablePin(), CallFunction->FindPinChecked(TEXT("Cache")));
+
+	//Input
+	CompilerContext.MovePinLinksToIntermediate(*FindPin(FGetGetterPinName::GetTargetPinName()), *CallFunction->FindPinChecked(TEXT("Target")));
+	CompilerContext.MovePinLinksToIntermediate(*FindPin(FGetGetterPinName::GetVarNamePinName()), *CallFunction->FindPinChecked(TEXT("VarName")));
+
+	//Output
+	CompilerContext.MovePinLinksToIntermediate(*ValuePin, *CallValuePin);
+	CompilerContext.MovePinLinksToIntermediate(*FindPin(FGetGetterPinName::GetOutputResultPinName()), *CallFunction->GetReturnValuePin());
+
+	BreakAllNodeLinks();
+}
+
 //This method adds our node to the context menu
 void UPSK2Node_GetObjectVarByName::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
 {
@@ -530,6 +624,16 @@ void UPSK2Node_GetObjectVarByName::GetMenuActions(FBlueprintActionDatabaseRegist
 		check(Spawner != nullptr);
 
 		ActionRegistrar.AddBlueprintAction(Action, Spawner);
+
+		UBlueprintNodeSpawner* PureSpawner = UBlueprintNodeSpawner::Create(GetClass());
+		check(PureSpawner != nullptr);
+
+		PureSpawner->CustomizeNodeDelegate = UBlueprintNodeSpawner::FCustomizeNodeDelegate::CreateStatic([](UEdGraphNode* NewNode, bool /*bIsTemplateNode*/)
+		{
+			CastChecked<UPSK2Node_GetObjectVarByName>(NewNode)->bIsPure = true;
+		});
+
+		ActionRegistrar.AddBlueprintAction(Action, PureSpawner);
 	}
 }
 
@@ -590,8 +694,9 @@ UEdGraphPin * UPSK2Node_GetObjectVarByName::GetThenPin() const
 {
 	const UEdGraphSchema_K2* K2Schema = GetDefault<UEdGraphSchema_K2>();
 
-	UEdGraphPin* Pin = FindPinChecked(UEdGraphSchema_K2::PN_Then);
-	check(Pin->Direction == EGPD_Output);
+	// Pure nodes have none
+	UEdGraphPin* Pin = FindPin(UEdGraphSchema_K2::PN_Then);
+	check(Pin == nullptr || Pin->Direction == EGPD_Output);
 	return Pin;
 }
 
@@ -618,37 +723,20 @@ UEdGraphPin * UPSK2Node_GetObjectVarByName::GetReturnResultPin() const
 
 UEdGraphPin * UPSK2Node_GetObjectVarByName::GetReturnValuePin() const
 {
-	if (Pins.Num() > 5)
-	{
-		//UE_LOG(LogTemp, Warning, TEXT("GetReturnValuePin[0]: Run."));
-		UEdGraphPin* Pin = FindPin(GetVarNamePin()->DefaultValue);
-		//UE_LOG(LogTemp, Warning, TEXT("GetReturnValuePin[0.1]: %s"), *GetVarNamePin()->DefaultValue);
-		check(Pin == NULL || Pin->Direction == EGPD_Output);
-		return Pin;
-	}
-	else
+	if (ResolvedPropertyName.IsNone())
 	{
 		return nullptr;
 	}
+
+	UEdGraphPin* Pin = FindPin(ResolvedPropertyName);
+	check(Pin == NULL || Pin->Direction == EGPD_Output);
+	return Pin;
 }
 
-FEdGraphPinType& UPSK2Node_GetObjectVarByName::GetReturnValueType() const
+const FEdGraphPinType& UPSK2Node_GetObjectVarByName::GetReturnValueType() const
 {
-	if (Pins.Num() > 5)
-	{
-		//UE_LOG(LogTemp, Warning, TEXT("GetReturnValueType[0]: Run."));
-		//UEdGraphPin* Pin = FindPin(FGetGetterPinName::GetOutputValuePinName());
-		UEdGraphPin* Pin = FindPin(GetVarNamePin()->DefaultValue);
-		//UE_LOG(LogTemp, Warning, TEXT("GetReturnValueType[0.1]: %s"), *GetVarNamePin()->DefaultValue);
-		check(Pin == NULL || Pin->Direction == EGPD_Output);
-		//UE_LOG(LogTemp, Warning, TEXT("GetReturnValueType[1]: %s."), *Pin->PinType.PinCategory.ToString());
-		return Pin->PinType;
-	}
-	else
-	{
-		FEdGraphPinType* out = new FEdGraphPinType();
-		return *out;
-	}
+	// Empty type (no category) until the variable resolves, FindGetterFunctionByType returns null for it
+	return ResolvedPinType;
 }
 
 ///Node type handling
@@ -685,7 +773,7 @@ void UPSK2Node_GetObjectVarByName::CoerceTypeForPin(const UEdGraphPin * Pin)
 ///Finders
 
 //find setter
-UFunction * UPSK2Node_GetObjectVarByName::FindGetterFunctionByType(FEdGraphPinType& PinType)
+UFunction * UPSK2Node_GetObjectVarByName::FindGetterFunctionByType(const FEdGraphPinType& PinType)
 {
 	UClass* LibraryClass = UPSData::StaticClass();
 	FName FunctionName = NAME_None;
@@ -750,6 +838,58 @@ UFunction * UPSK2Node_GetObjectVarByName::FindGetterFunctionByType(FEdGraphPinTy
 	return Function;
 }
 
+//find the inline cached version, only some types have one
+UFunction * UPSK2Node_GetObjectVarByName::FindCachedGetterFunctionByType(const FEdGraphPinType& PinType)
+{
+	UClass* LibraryClass = UPSData::StaticClass();
+	FName FunctionName = NAME_None;
+	UFunction* Function = nullptr;
+
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Float)
+	{
+		FunctionName = FSetterFunctionNames::FloatCachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Int)
+	{
+		FunctionName = FSetterFunctionNames::IntCachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Int64)
+	{
+		FunctionName = FSetterFunctionNames::Int64CachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Boolean)
+	{
+		FunctionName = FSetterFunctionNames::BoolCachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Name)
+	{
+		FunctionName = FSetterFunctionNames::NameCachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Object)
+	{
+		FunctionName = FSetterFunctionNames::ObjectCachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Byte)
+	{
+		FunctionName = FSetterFunctionNames::ByteCachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_String)
+	{
+		FunctionName = FSetterFunctionNames::StringCachedGetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Text)
+	{
+		FunctionName = FSetterFunctionNames::TextCachedGetterName;
+	}
+
+	if (!FunctionName.IsNone())
+	{
+		Function = LibraryClass->FindFunctionByName(FunctionName);
+	}
+
+	return Function;
+}
+
 ///Protected
 
 UClass* UPSK2Node_GetObjectVarByName::GetInputClass(const UEdGraphPin* FromPin) const
@@ -828,107 +968,59 @@ void UPSK2Node_GetObjectVarByName::OnBlueprintClassModified(UBlueprint* TargetBl
 
 void UPSK2Node_GetObjectVarByName::CreateOutputPins(UClass* InClass)
 {
-	//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[0]: Run."));
-	// Create the set of output pins through the optional pin manager
-	//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[0.1]: Total Outputs to create: %s"), *FString::FromInt(ShowPinForProperties.Num()));
-	FGetObjectVarOptionalPinManager OptionalPinManager(InClass, bExcludeObjectContainers, bExcludeObjectArrays_DEPRECATED);
-	OptionalPinManager.RebuildPropertyList(ShowPinForProperties, InClass);
-	UpdateShowPinForProperties();
-	//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[0.2]: Total Outputs to create: %s"), *FString::FromInt(ShowPinForProperties.Num()));
-	
-	//I added
-	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
-	UEdGraphPin* OutValidPin = CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Boolean, FGetGetterPinName::GetOutputResultPinName());
-	//end
+	PS_GETTER_NODE_LLM_SCOPE();
 
-	if (CheckVarExists(ShowPinForProperties[0], InClass))
+	// AllocateDefaultPins may have made these already
+	if (!bIsPure && !FindPin(UEdGraphSchema_K2::PN_Then, EGPD_Output))
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[0.3]: Var exists."));
-		OptionalPinManager.CreateVisiblePins(ShowPinForProperties, InClass, EGPD_Output, this);
+		CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
 	}
-	else
+	if (!FindPin(FGetGetterPinName::GetOutputResultPinName(), EGPD_Output))
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[0.4]: Var does not exist."));
-		return;
+		CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Boolean, FGetGetterPinName::GetOutputResultPinName());
 	}
 
-	// Check for any advanced properties (outputs)
-	bool bHasAdvancedPins = false;
-	for (int32 PinIndex = 0; PinIndex < Pins.Num() && !bHasAdvancedPins; ++PinIndex)
-	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[1]: For Pins.Num()."));
-		UEdGraphPin* Pin = Pins[PinIndex];
-		check(Pin != nullptr);
-
-		bHasAdvancedPins |= Pin->bAdvancedView;
-	}
+	ResolvedPropertyName = NAME_None;
+	ResolvedPinType = FEdGraphPinType();
 
-	// Toggle advanced display on/off based on whether or not we have any advanced outputs
-	if (bHasAdvancedPins && AdvancedPinDisplay == ENodeAdvancedPins::NoPins)
+	UEdGraphPin* VarNamePin = GetVarNamePin();
+	if (!InClass || !VarNamePin)
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[2]: HasAdvanced && NoPins."));
-		AdvancedPinDisplay = ENodeAdvancedPins::Hidden;
+		return;
 	}
-	else if (!bHasAdvancedPins)
+
+	// Only the one variable gets a pin, so look it up directly rather than building a pin record for every property of the class
+	const UEdGraphSchema_K2* K2Schema = GetDefault<UEdGraphSchema_K2>();
+	UProperty* Property = FindField<UProperty>(InClass, *VarNamePin->DefaultValue);
+	if (!CanExposeProperty(Property, bExcludeObjectContainers || bExcludeObjectArrays_DEPRECATED, bExcludeObjectContainers)
+		|| !K2Schema->ConvertPropertyToPinType(Property, ResolvedPinType))
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[4]: !HasAdvanced."));
-		AdvancedPinDisplay = ENodeAdvancedPins::NoPins;
+		ResolvedPinType = FEdGraphPinType();
+		return;
 	}
 
-	// Unbind OnChanged() delegate from a previous Blueprint, if valid.
+	ResolvedPropertyName = Property->GetFName();
+
+	UEdGraphPin* ValuePin = CreatePin(EGPD_Output, ResolvedPinType, ResolvedPropertyName);
+	K2Schema->ConstructBasicPinTooltip(*ValuePin, Property->GetToolTipText(), ValuePin->PinToolTip);
+
+	// Move into the advanced view if the property metadata is set.
+	ValuePin->bAdvancedView = Property->HasAnyPropertyFlags(CPF_AdvancedDisplay);
 
-	// If the class was generated for a Blueprint, bind delegates to handle any OnChanged() & OnCompiled() events.
-	bool bShouldClearDelegate = true;
-	if (InClass)
+	// Toggle advanced display on/off based on whether or not we have any advanced outputs
+	if (ValuePin->bAdvancedView && AdvancedPinDisplay == ENodeAdvancedPins::NoPins)
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[5]: InClass valid."));
-		if (UBlueprint* Blueprint = Cast<UBlueprint>(InClass->ClassGeneratedBy))
-		{
-			//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[7]: Blueprint from InClass."));
-			// only clear the delegate if the pin has changed:
-			bShouldClearDelegate = BlueprintSubscribedTo != Blueprint;
-		}
+		AdvancedPinDisplay = ENodeAdvancedPins::Hidden;
 	}
-
-	if (bShouldClearDelegate)
+	else if (!ValuePin->bAdvancedView)
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[8]: ShouldClearDelegate."));
-		if (OnBlueprintChangedDelegate.IsValid())
-		{
-			//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[9]: OnBlueprintChangedDelegate valid."));
-			if (BlueprintSubscribedTo)
-			{
-				//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[10]: BlueprintSubscribedTo."));
-				BlueprintSubscribedTo->OnChanged().Remove(OnBlueprintChangedDelegate);
-			}
-			OnBlueprintChangedDelegate.Reset();
-		}
-
-		// Unbind OnCompiled() delegate from a previous Blueprint, if valid.
-		if (OnBlueprintCompiledDelegate.IsValid())
-		{
-			//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[11]: OnBklueprintCompiledDelegate is valid."));
-			if (BlueprintSubscribedTo)
-			{
-				//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[12]: BlueprintSubscribedTo."));
-				BlueprintSubscribedTo->OnCompiled().Remove(OnBlueprintCompiledDelegate);
-			}
-			OnBlueprintCompiledDelegate.Reset();
-		}
-		// Associated Blueprint changed, clear the BlueprintSubscribedTo:
-		BlueprintSubscribedTo = nullptr;
+		AdvancedPinDisplay = ENodeAdvancedPins::NoPins;
 	}
 
-	if (InClass && bShouldClearDelegate)
+	// If the class was generated for a Blueprint, rebuild when it changes or compiles
+	if (UBlueprint* Blueprint = Cast<UBlueprint>(InClass->ClassGeneratedBy))
 	{
-		//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[13]: InClass && bShouldClearDelegate."));
-		if (UBlueprint* Blueprint = Cast<UBlueprint>(InClass->ClassGeneratedBy))
-		{
-			//UE_LOG(LogTemp, Warning, TEXT("CreateOutputPins[14]: Blueprint from InClass."));
-			BlueprintSubscribedTo = Blueprint;
-			OnBlueprintChangedDelegate = Blueprint->OnChanged().AddUObject(this, &ThisClass::OnBlueprintClassModified);
-			OnBlueprintCompiledDelegate = Blueprint->OnCompiled().AddUObject(this, &ThisClass::OnBlueprintClassModified);
-		}
+		FPSGetterBlueprintWatcher::Get().Watch(Blueprint, this);
 	}
 }
 
@@ -949,9 +1041,6 @@ void UPSK2Node_GetObjectVarByName::OnClassPinChanged()
 		}
 	}
 
-	// Clear the current output pin settings (so they don't carry over to the new set)
-	ShowPinForProperties.Reset();
-
 	// Create output pins for the new class type
 	UClass* InputClass = GetInputClass();
 	CreateOutputPins(InputClass);
@@ -979,33 +1068,4 @@ void UPSK2Node_GetObjectVarByName::OnVarNamePinChanged()
 	OnClassPinChanged();
 }
 
-void UPSK2Node_GetObjectVarByName::UpdateShowPinForProperties()
-{
-	//UE_LOG(LogTemp, Warning, TEXT("UpdateShowPinForProperties[0]: Run."));
-	ShowPinForProperties.Empty();
-
-	FOptionalPinFromProperty PinProps = FOptionalPinFromProperty();
-
-	PinProps.PropertyName = *GetVarNamePin()->DefaultValue;
-	PinProps.bShowPin = true;
-	PinProps.bIsSetValuePinVisible = true;
-	//UE_LOG(LogTemp, Warning, TEXT("UpdateShowPinForProperties[1]: Pin value %s."), *GetVarNamePin()->DefaultValue);
-	ShowPinForProperties.Add(PinProps);
-	//UE_LOG(LogTemp, Warning, TEXT("UpdateShowPinForProperties[2]: Length %s."), *FString::FromInt(ShowPinForProperties.Num()));
-}
-
-bool UPSK2Node_GetObjectVarByName::CheckVarExists(FOptionalPinFromProperty& Prop, UStruct * InClass)
-{
-	bool Out = false;
-
-	UProperty* OuterProperty = nullptr;
-	OuterProperty = FindField<UProperty>(InClass, Prop.PropertyName);
-	if (OuterProperty)
-	{
-		Out = true;
-	}
-
-	return Out;
-}
-
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -24,11 +24,6 @@ class NFPOPULATIONSYSTEMEDITOR_API UPSK2Node_GetObjectVarByName : public UK2Node
 
 public:
 
-	//~ Begin UObject Interface
-	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
-	virtual void PreEditChange(UProperty* PropertyAboutToChange) override;
-	//~ End UObject Interface
-
 	//UEdGraphNode implementation
 	virtual void AllocateDefaultPins() override;
 	virtual void PostPlacedNewNode() override;
@@ -40,7 +35,8 @@ public:
 	//UEdGraphNode implementation
 
 	//K2Node implementation
-	virtual bool ShouldShowNodeProperties() const override { return true; }
+	virtual bool ShouldShowNodeProperties() const override { return false; }
+	virtual bool IsNodePure() const override { return bIsPure; }
 	virtual void ReallocatePinsDuringReconstruction(TArray<UEdGraphPin*>& OldPins) override;
 	virtual bool HasExternalDependencies(TArray<class UStruct*>* OptionalOutput) const override;
 	virtual class FNodeHandlingFunctor* CreateNodeHandler(class FKismetCompilerContext& CompilerContext) const override;
@@ -56,12 +52,15 @@ public:
 	UEdGraphPin* GetVarNamePin() const;
 	UEdGraphPin* GetReturnResultPin() const;
 	UEdGraphPin* GetReturnValuePin() const;
-	FEdGraphPinType& GetReturnValueType() const;
+	const FEdGraphPinType& GetReturnValueType() const;
 	
 	//Custom functions
 	//void CoerceTypeForPin(const UEdGraphPin* Pin);
 
-	static UFunction* FindGetterFunctionByType(FEdGraphPinType& PinType);
+	static UFunction* FindGetterFunctionByType(const FEdGraphPinType& PinType);
+
+	/** The version of the getter that takes a call site FPSInlineCache, null for types that don't have one. */
+	static UFunction* FindCachedGetterFunctionByType(const FEdGraphPinType& PinType);
 
 	/** Retrieves the current input class type. */
 	/*BLUEPRINTGRAPH_API*/ UClass* GetInputClass() const
@@ -82,7 +81,7 @@ protected:
 	/*BLUEPRINTGRAPH_API*/ UClass* GetInputClass(const UEdGraphPin* FromPin) const;
 
 	/**
-	 * Creates the full set of output pins (properties) from the given input class.
+	 * Creates the output pins, including the value pin for the variable named on the VarName pin if the given input class has it.
 	 *
 	 * @param InClass	Input class type.
 	 */
@@ -95,21 +94,20 @@ protected:
 
 private:
 
-	/** Blueprint that we subscribed OnBlueprintChangedDelegate and OnBlueprintCompiledDelegate to */
-	UPROPERTY()
-		UBlueprint* BlueprintSubscribedTo;
-
-	/** Blueprint.OnChanged delegate handle */
-	FDelegateHandle OnBlueprintChangedDelegate;
+	/** Expansion for the pure variant: one GetValueByNameCached call with its own inline cache. */
+	void ExpandPureNode(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph);
 
-	/** Blueprint.OnCompiled delegate handle */
-	FDelegateHandle OnBlueprintCompiledDelegate;
+	/** Pure variant, no exec pins. Set by the spawner that places it. */
+	UPROPERTY()
+		bool bIsPure;
 
-	/** Output pin visibility control */
-	UPROPERTY(EditAnywhere, Category = PinOptions, EditFixedSize)
-		TArray<FOptionalPinFromProperty> ShowPinForProperties;
+	/** Name of the variable the output pin was built for, None until it resolves */
+	UPROPERTY()
+		FName ResolvedPropertyName;
 
-	TArray<FName> OldShownPins;
+	/** Type of the output pin, kept so the getter can be picked without finding the pin or the property again */
+	UPROPERTY()
+		FEdGraphPinType ResolvedPinType;
 
 	/** Whether or not to exclude object container properties */
 	UPROPERTY()
@@ -118,7 +116,4 @@ private:
 	/** Whether or not to exclude object array properties (deprecated) */
 	UPROPERTY()
 		bool bExcludeObjectArrays_DEPRECATED;
-
-	void UpdateShowPinForProperties();
-	bool CheckVarExists(FOptionalPinFromProperty& Prop, UStruct* InClass);
 };
@@ -11,6 +11,7 @@
 #include "BlueprintActionDatabaseRegistrar.h"
 #include "BlueprintNodeSpawner.h"
 #include "K2Node_CallFunction.h"
+#include "K2Node_TemporaryVariable.h"
 
 #define LOCTEXT_NAMESPACE "PSK2Node_SetObjectVarByName"
 
@@ -62,6 +63,16 @@ namespace FSetterFunctionNames
 	static const FName TextSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetTextByName));
 	static const FName StructSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetStructByName));
 	static const FName EnumSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetEnumByName));
+
+	static const FName FloatCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetFloatByNameCached));
+	static const FName IntCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetIntByNameCached));
+	static const FName Int64CachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetInt64ByNameCached));
+	static const FName BoolCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetBoolByNameCached));
+	static const FName NameCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetNameByNameCached));
+	static const FName ObjectCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetObjectByNameCached));
+	static const FName ByteCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetByteByNameCached));
+	static const FName StringCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetStringByNameCached));
+	static const FName TextCachedSetterName(GET_FUNCTION_NAME_CHECKED(UPSData, SetTextByNameCached));
 };
 
 void UPSK2Node_SetObjectVarByName::AllocateDefaultPins()
@@ -125,7 +136,8 @@ void UPSK2Node_SetObjectVarByName::ExpandNode(class FKismetCompilerContext& Comp
 {
 	Super::ExpandNode(CompilerContext, SourceGraph);
 
-	UFunction* BlueprintFunction = FindSetterFunctionByType(GetNewValuePin()->PinType);
+	UFunction* CachedFunction = FindCachedSetterFunctionByType(GetNewValuePin()->PinType);
+	UFunction* BlueprintFunction = CachedFunction ? CachedFunction : FindSetterFunctionByType(GetNewValuePin()->PinType);
 
 	if (!BlueprintFunction)
 	{
@@ -139,6 +151,14 @@ void UPSK2Node_SetObjectVarByName::ExpandNode(class FKismetCompilerContext& Comp
 	CallFunction->AllocateDefaultPins();
 	CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallFunction, this);
 
+	if (CachedFunction)
+	{
+		// In the event graph the cache lives in the ubergraph frame, which lasts as long as the object, so it keeps its entries from one
+		// event to the next. In a function it is a local that starts out empty on every call, so there it only pays off for nodes in loops.
+		UK2Node_TemporaryVariable* InlineCache = CompilerContext.SpawnInternalVariable(this, UEdGraphSchema_K2::PC_Struct, NAME_None, FPSInlineCache::StaticStruct());
+		CompilerContext.GetSchema()->TryCreateConnection(InlineCache->GetVariablePin(), CallFunction->FindPinChecked(TEXT("Cache")));
+	}
+
 	//Input
 	CompilerContext.MovePinLinksToIntermediate(*FindPin(FGetPinName::GetTargetPinName()), *CallFunction->FindPinChecked(TEXT("Target")));
 	CompilerContext.MovePinLinksToIntermediate(*FindPin(FGetPinName::GetVarNamePinName()), *CallFunction->FindPinChecked(TEXT("VarName")));
@@ -350,4 +370,56 @@ UFunction * UPSK2Node_SetObjectVarByName::FindSetterFunctionByType(FEdGraphPinTy
 	return Function;
 }
 
+//find the inline cached version, only some types have one
+UFunction * UPSK2Node_SetObjectVarByName::FindCachedSetterFunctionByType(const FEdGraphPinType& PinType)
+{
+	UClass* LibraryClass = UPSData::StaticClass();
+	FName FunctionName = NAME_None;
+	UFunction* Function = nullptr;
+
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Float)
+	{
+		FunctionName = FSetterFunctionNames::FloatCachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Int)
+	{
+		FunctionName = FSetterFunctionNames::IntCachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Int64)
+	{
+		FunctionName = FSetterFunctionNames::Int64CachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Boolean)
+	{
+		FunctionName = FSetterFunctionNames::BoolCachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Name)
+	{
+		FunctionName = FSetterFunctionNames::NameCachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Object)
+	{
+		FunctionName = FSetterFunctionNames::ObjectCachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Byte)
+	{
+		FunctionName = FSetterFunctionNames::ByteCachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_String)
+	{
+		FunctionName = FSetterFunctionNames::StringCachedSetterName;
+	}
+	if (PinType.PinCategory == UEdGraphSchema_K2::PC_Text)
+	{
+		FunctionName = FSetterFunctionNames::TextCachedSetterName;
+	}
+
+	if (!FunctionName.IsNone())
+	{
+		Function = LibraryClass->FindFunctionByName(FunctionName);
+	}
+
+	return Function;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
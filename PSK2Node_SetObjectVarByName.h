@@ -43,4 +43,7 @@ public:
 
 	static UFunction* FindSetterFunctionByType(FEdGraphPinType& PinType);
 
+	/** The version of the setter that takes a call site FPSInlineCache, null for types that don't have one. */
+	static UFunction* FindCachedSetterFunctionByType(const FEdGraphPinType& PinType);
+
 };
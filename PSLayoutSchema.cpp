@@ -0,0 +1,345 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSLayoutSchema.h"
+
+#include "Misc/ScopeRWLock.h"
+#include "Templates/UniquePtr.h"
+
+namespace
+{
+	struct FPSLayoutSchemaStorage
+	{
+		FPSLayoutSchemaStorage()
+			: Generation(0)
+		{
+		}
+
+		FRWLock Lock;
+		TMap<TPair<const UClass*, const UScriptStruct*>, TUniquePtr<FPSLayoutSchema>> Schemas;
+
+		/** FPSPropertyCache generation the schemas were built in */
+		uint32 Generation;
+	};
+
+	FPSLayoutSchemaStorage& GetStorage()
+	{
+		static FPSLayoutSchemaStorage Storage;
+		return Storage;
+	}
+
+	bool IsFloatingPoint(EPSNumericKind Kind)
+	{
+		return Kind == EPSNumericKind::Float || Kind == EPSNumericKind::Double;
+	}
+
+	double ReadDouble(const uint8* Address, EPSNumericKind Kind)
+	{
+		switch (Kind)
+		{
+		case EPSNumericKind::Float:		return *reinterpret_cast<const float*>(Address);
+		case EPSNumericKind::Double:	return *reinterpret_cast<const double*>(Address);
+		case EPSNumericKind::Int8:		return *reinterpret_cast<const int8*>(Address);
+		case EPSNumericKind::Int16:		return *reinterpret_cast<const int16*>(Address);
+		case EPSNumericKind::Int32:		return *reinterpret_cast<const int32*>(Address);
+		case EPSNumericKind::Int64:		return (double)*reinterpret_cast<const int64*>(Address);
+		case EPSNumericKind::UInt8:		return *reinterpret_cast<const uint8*>(Address);
+		case EPSNumericKind::UInt16:	return *reinterpret_cast<const uint16*>(Address);
+		case EPSNumericKind::UInt32:	return *reinterpret_cast<const uint32*>(Address);
+		case EPSNumericKind::UInt64:	return (double)*reinterpret_cast<const uint64*>(Address);
+		default:						return 0.0;
+		}
+	}
+
+	int64 ReadInt(const uint8* Address, EPSNumericKind Kind)
+	{
+		switch (Kind)
+		{
+		case EPSNumericKind::Int8:		return *reinterpret_cast<const int8*>(Address);
+		case EPSNumericKind::Int16:		return *reinterpret_cast<const int16*>(Address);
+		case EPSNumericKind::Int32:		return *reinterpret_cast<const int32*>(Address);
+		case EPSNumericKind::Int64:		return *reinterpret_cast<const int64*>(Address);
+		case EPSNumericKind::UInt8:		return *reinterpret_cast<const uint8*>(Address);
+		case EPSNumericKind::UInt16:	return *reinterpret_cast<const uint16*>(Address);
+		case EPSNumericKind::UInt32:	return *reinterpret_cast<const uint32*>(Address);
+		case EPSNumericKind::UInt64:	return (int64)*reinterpret_cast<const uint64*>(Address);
+		default:						return 0;
+		}
+	}
+
+	template<typename ValueType>
+	void WriteNumber(uint8* Address, EPSNumericKind Kind, ValueType Value)
+	{
+		switch (Kind)
+		{
+		case EPSNumericKind::Float:		*reinterpret_cast<float*>(Address) = (float)Value; break;
+		case EPSNumericKind::Double:	*reinterpret_cast<double*>(Address) = (double)Value; break;
+		case EPSNumericKind::Int8:		*reinterpret_cast<int8*>(Address) = FPSNumericAccess::Convert<int8>(Value); break;
+		case EPSNumericKind::Int16:		*reinterpret_cast<int16*>(Address) = FPSNumericAccess::Convert<int16>(Value); break;
+		case EPSNumericKind::Int32:		*reinterpret_cast<int32*>(Address) = FPSNumericAccess::Convert<int32>(Value); break;
+		case EPSNumericKind::Int64:		*reinterpret_cast<int64*>(Address) = FPSNumericAccess::Convert<int64>(Value); break;
+		case EPSNumericKind::UInt8:		*reinterpret_cast<uint8*>(Address) = FPSNumericAccess::Convert<uint8>(Value); break;
+		case EPSNumericKind::UInt16:	*reinterpret_cast<uint16*>(Address) = FPSNumericAccess::Convert<uint16>(Value); break;
+		case EPSNumericKind::UInt32:	*reinterpret_cast<uint32*>(Address) = FPSNumericAccess::Convert<uint32>(Value); break;
+		case EPSNumericKind::UInt64:	*reinterpret_cast<uint64*>(Address) = FPSNumericAccess::Convert<uint64>(Value); break;
+		default:						break;
+		}
+	}
+
+	// Ints stay ints all the way, a double can't hold every int64
+	void ConvertNumber(uint8* To, EPSNumericKind ToKind, const uint8* From, EPSNumericKind FromKind)
+	{
+		if (IsFloatingPoint(FromKind) || IsFloatingPoint(ToKind))
+		{
+			WriteNumber(To, ToKind, ReadDouble(From, FromKind));
+		}
+		else
+		{
+			WriteNumber(To, ToKind, ReadInt(From, FromKind));
+		}
+	}
+
+	// Native members go by their name, user defined struct members by the name they were given in the editor
+	const UProperty* FindStructMember(const UScriptStruct* Struct, FName VarName)
+	{
+		const FString VarNameString = VarName.ToString();
+		for (TFieldIterator<UProperty> It(Struct); It; ++It)
+		{
+			if (It->GetFName() == VarName || Struct->PropertyNameToDisplayName(It->GetFName()) == VarNameString)
+			{
+				return *It;
+			}
+		}
+		return nullptr;
+	}
+}
+
+FPSLayoutSchema::FPSLayoutSchema()
+	: Struct(nullptr)
+	, NumBoundVars(0)
+	, NumConvertedVars(0)
+	, Generation(0)
+{
+}
+
+FPSLayoutSchema::FPSLayoutSchema(const UClass* InClass, const TArray<FName>& InVarNames, const UScriptStruct* InStruct)
+	: Class(InClass)
+	, Struct(InStruct)
+	, NumBoundVars(0)
+	, NumConvertedVars(0)
+	, Generation(FPSPropertyCache::GetGeneration())
+{
+	BoundVars.SetNumZeroed(InVarNames.Num());
+
+	if (!InClass || !InStruct)
+	{
+		return;
+	}
+
+	TArray<FCopyOp> BlockOps;
+
+	for (int32 VarIndex = 0; VarIndex < InVarNames.Num(); ++VarIndex)
+	{
+		const UProperty* ObjectProperty = FPSPropertyCache::FindProperty(InClass, InVarNames[VarIndex]);
+		const UProperty* StructProperty = ObjectProperty ? FindStructMember(InStruct, InVarNames[VarIndex]) : nullptr;
+		if (!StructProperty || ObjectProperty->ArrayDim != StructProperty->ArrayDim)
+		{
+			continue;
+		}
+
+		FCopyOp Op;
+		Op.ObjectOffset = ObjectProperty->GetOffset_ForInternal();
+		Op.StructOffset = StructProperty->GetOffset_ForInternal();
+		Op.Size = ObjectProperty->ElementSize * ObjectProperty->ArrayDim;
+		Op.ObjectProperty = ObjectProperty;
+		Op.StructProperty = StructProperty;
+		Op.ObjectKind = EPSNumericKind::None;
+		Op.StructKind = EPSNumericKind::None;
+
+		const bool bObjectBool = ObjectProperty->IsA<UBoolProperty>();
+		const bool bStructBool = StructProperty->IsA<UBoolProperty>();
+		if (bObjectBool || bStructBool)
+		{
+			if (!bObjectBool || !bStructBool || ObjectProperty->ArrayDim != 1)
+			{
+				continue;
+			}
+			Op.Kind = ECopyKind::Bool;
+			CopyOps.Add(Op);
+		}
+		else if (!ObjectProperty->SameType(StructProperty))
+		{
+			Op.ObjectKind = FPSPropertyCache::GetNumericKind(ObjectProperty);
+			Op.StructKind = FPSPropertyCache::GetNumericKind(StructProperty);
+			if (Op.ObjectKind == EPSNumericKind::None || Op.StructKind == EPSNumericKind::None || ObjectProperty->ArrayDim != 1)
+			{
+				continue;
+			}
+			Op.Kind = ECopyKind::Numeric;
+			CopyOps.Add(Op);
+			++NumConvertedVars;
+		}
+		else if (ObjectProperty->HasAnyPropertyFlags(CPF_IsPlainOldData))
+		{
+			Op.Kind = ECopyKind::Block;
+			BlockOps.Add(Op);
+		}
+		else
+		{
+			Op.Kind = ECopyKind::Property;
+			CopyOps.Add(Op);
+		}
+
+		BoundVars[VarIndex] = true;
+		++NumBoundVars;
+	}
+
+	// Merge blocks that follow each other on both sides. Blocks never overlap, so the order they are copied in doesn't matter.
+	BlockOps.Sort([](const FCopyOp& A, const FCopyOp& B) { return A.ObjectOffset < B.ObjectOffset; });
+
+	TArray<FCopyOp> MergedOps;
+	MergedOps.Reserve(BlockOps.Num() + CopyOps.Num());
+
+	for (const FCopyOp& Op : BlockOps)
+	{
+		if (MergedOps.Num() > 0)
+		{
+			FCopyOp& Last = MergedOps.Last();
+			if (Last.ObjectOffset + Last.Size == Op.ObjectOffset && Last.StructOffset + Last.Size == Op.StructOffset)
+			{
+				Last.Size += Op.Size;
+				continue;
+			}
+		}
+
+		FCopyOp& NewOp = MergedOps.Add_GetRef(Op);
+		NewOp.ObjectProperty = nullptr;
+		NewOp.StructProperty = nullptr;
+	}
+
+	MergedOps.Append(CopyOps);
+	CopyOps = MoveTemp(MergedOps);
+}
+
+const FPSLayoutSchema* FPSLayoutSchema::GetByNames(const UClass* Class, const UScriptStruct* Struct)
+{
+	if (!Class || !Struct)
+	{
+		return nullptr;
+	}
+
+	FPSLayoutSchemaStorage& Storage = GetStorage();
+	const TPair<const UClass*, const UScriptStruct*> Key(Class, Struct);
+	const uint32 Generation = FPSPropertyCache::GetGeneration();
+
+	{
+		FRWScopeLock ScopeLock(Storage.Lock, SLT_ReadOnly);
+		if (Storage.Generation == Generation)
+		{
+			if (const TUniquePtr<FPSLayoutSchema>* Schema = Storage.Schemas.Find(Key))
+			{
+				if ((*Schema)->Class.Get() == Class)
+				{
+					return Schema->Get();
+				}
+			}
+		}
+	}
+
+	// Bind by the names the members were authored with, which for user defined structs isn't their FName
+	TArray<FName> VarNames;
+	for (TFieldIterator<UProperty> It(Struct); It; ++It)
+	{
+		VarNames.Add(*Struct->PropertyNameToDisplayName(It->GetFName()));
+	}
+
+	TUniquePtr<FPSLayoutSchema> NewSchema(new FPSLayoutSchema(Class, VarNames, Struct));
+
+	FRWScopeLock ScopeLock(Storage.Lock, SLT_Write);
+	if (Storage.Generation != Generation)
+	{
+		// Classes got reinstanced, every schema may be out of date
+		Storage.Schemas.Reset();
+		Storage.Generation = Generation;
+	}
+
+	TUniquePtr<FPSLayoutSchema>& Schema = Storage.Schemas.FindOrAdd(Key);
+	if (!Schema.IsValid() || Schema->Class.Get() != Class)
+	{
+		Schema = MoveTemp(NewSchema);
+	}
+	return Schema.Get();
+}
+
+bool FPSLayoutSchema::Read(const UObject* Object, void* StructData) const
+{
+	const UClass* SchemaClass = Class.Get();
+	if (!Object || !StructData || !SchemaClass || !Object->IsA(SchemaClass) || IsStale())
+	{
+		return false;
+	}
+
+	const uint8* ObjectData = reinterpret_cast<const uint8*>(Object);
+	uint8* StructBytes = static_cast<uint8*>(StructData);
+
+	for (const FCopyOp& Op : CopyOps)
+	{
+		switch (Op.Kind)
+		{
+		case ECopyKind::Block:
+			FMemory::Memcpy(StructBytes + Op.StructOffset, ObjectData + Op.ObjectOffset, Op.Size);
+			break;
+		case ECopyKind::Bool:
+			static_cast<const UBoolProperty*>(Op.StructProperty)->SetPropertyValue(StructBytes + Op.StructOffset,
+				static_cast<const UBoolProperty*>(Op.ObjectProperty)->GetPropertyValue(ObjectData + Op.ObjectOffset));
+			break;
+		case ECopyKind::Numeric:
+			ConvertNumber(StructBytes + Op.StructOffset, Op.StructKind, ObjectData + Op.ObjectOffset, Op.ObjectKind);
+			break;
+		case ECopyKind::Property:
+			Op.StructProperty->CopyCompleteValue(StructBytes + Op.StructOffset, ObjectData + Op.ObjectOffset);
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool FPSLayoutSchema::Write(UObject* Object, const void* StructData) const
+{
+	const UClass* SchemaClass = Class.Get();
+	if (!Object || !StructData || !SchemaClass || !Object->IsA(SchemaClass) || IsStale())
+	{
+		return false;
+	}
+
+	uint8* ObjectData = reinterpret_cast<uint8*>(Object);
+	const uint8* StructBytes = static_cast<const uint8*>(StructData);
+
+	for (const FCopyOp& Op : CopyOps)
+	{
+		switch (Op.Kind)
+		{
+		case ECopyKind::Block:
+			FMemory::Memcpy(ObjectData + Op.ObjectOffset, StructBytes + Op.StructOffset, Op.Size);
+			break;
+		case ECopyKind::Bool:
+			static_cast<const UBoolProperty*>(Op.ObjectProperty)->SetPropertyValue(ObjectData + Op.ObjectOffset,
+				static_cast<const UBoolProperty*>(Op.StructProperty)->GetPropertyValue(StructBytes + Op.StructOffset));
+			break;
+		case ECopyKind::Numeric:
+			ConvertNumber(ObjectData + Op.ObjectOffset, Op.ObjectKind, StructBytes + Op.StructOffset, Op.StructKind);
+			break;
+		case ECopyKind::Property:
+			Op.ObjectProperty->CopyCompleteValue(ObjectData + Op.ObjectOffset, StructBytes + Op.StructOffset);
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool FPSLayoutSchema::IsStale() const
+{
+	return Generation != FPSPropertyCache::GetGeneration();
+}
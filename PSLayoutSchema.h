@@ -0,0 +1,110 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UnrealType.h"
+#include "UObject/WeakObjectPtr.h"
+
+#include "PSPropertyCache.h"
+
+/**
+ * Binds a fixed list of variables of a class to the same-named members of a struct, once,
+ * so an object can be read into the struct (or written back from it) in one call with no lookups.
+ * Members that are plain old data and sit next to each other on both sides, in the same order, are copied as one block.
+ * Numbers of different types (float, double, ints of any width, bytes and enums) are converted. Floating point values going into ints
+ * truncate towards zero and saturate at the int's range, ints going into narrower ints wrap like a C cast.
+ * Variables the class doesn't have, or whose struct member is missing or of another non-numeric type, are left out.
+ * Writes go straight to memory, they are not journaled.
+ */
+class NFPOPULATIONSYSTEM_API FPSLayoutSchema
+{
+public:
+
+	FPSLayoutSchema();
+	FPSLayoutSchema(const UClass* InClass, const TArray<FName>& InVarNames, const UScriptStruct* InStruct);
+
+	/**
+	 * Shared schema binding every member of Struct to the same-named variable of Class, built on first use for each pair.
+	 * Valid until classes get reinstanced (Blueprint recompile, hot reload).
+	 */
+	static const FPSLayoutSchema* GetByNames(const UClass* Class, const UScriptStruct* Struct);
+
+	/** Copies the bound variables of Object into StructData, which must be an initialized InStruct. Fails if Object isn't of the class or the schema is stale. */
+	bool Read(const UObject* Object, void* StructData) const;
+
+	/** Copies the bound members of StructData back into Object. Fails if Object isn't of the class or the schema is stale. */
+	bool Write(UObject* Object, const void* StructData) const;
+
+	template<typename StructType>
+	bool Read(const UObject* Object, StructType& OutStruct) const
+	{
+		check(StructType::StaticStruct() == Struct);
+		return Read(Object, &OutStruct);
+	}
+
+	template<typename StructType>
+	bool Write(UObject* Object, const StructType& InStruct) const
+	{
+		check(StructType::StaticStruct() == Struct);
+		return Write(Object, &InStruct);
+	}
+
+	/** Whether VarNames[VarIndex] found a match and is copied. */
+	bool IsBound(int32 VarIndex) const { return BoundVars.IsValidIndex(VarIndex) && BoundVars[VarIndex]; }
+
+	int32 NumBound() const { return NumBoundVars; }
+
+	/** Bound variables whose numeric type differs between the class and the struct. */
+	int32 NumConverted() const { return NumConvertedVars; }
+
+	/** Copy operations left after merging, at most one per bound variable. */
+	int32 NumCopyOps() const { return CopyOps.Num(); }
+
+	/** Classes were reinstanced since the schema was built, and offsets may have moved. Build it again. */
+	bool IsStale() const;
+
+	const UClass* GetClass() const { return Class.Get(); }
+	const UScriptStruct* GetStruct() const { return Struct; }
+
+private:
+
+	enum class ECopyKind : uint8
+	{
+		/** memcpy of Size bytes */
+		Block,
+
+		/** A bool on either side, which may be a bitfield */
+		Bool,
+
+		/** Numbers of different types */
+		Numeric,
+
+		/** Anything that needs the property to copy it (strings, arrays, structs with their own copy...) */
+		Property
+	};
+
+	struct FCopyOp
+	{
+		ECopyKind Kind;
+		int32 ObjectOffset;
+		int32 StructOffset;
+		int32 Size;
+
+		/** Only set for Bool and Property copies */
+		const UProperty* ObjectProperty;
+		const UProperty* StructProperty;
+
+		/** Only set for Numeric copies */
+		EPSNumericKind ObjectKind;
+		EPSNumericKind StructKind;
+	};
+
+	TWeakObjectPtr<const UClass> Class;
+	const UScriptStruct* Struct;
+	TArray<FCopyOp> CopyOps;
+	TArray<bool> BoundVars;
+	int32 NumBoundVars;
+	int32 NumConvertedVars;
+	uint32 Generation;
+};
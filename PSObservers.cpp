@@ -0,0 +1,339 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSObservers.h"
+
+#include "PSJournal.h"
+#include "PSPropertyCache.h"
+
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	struct FPSObserver
+	{
+		/** Set for object observers */
+		FWeakObjectPtr Target;
+
+		/** Set for class observers */
+		FWeakObjectPtr Class;
+
+		bool bTargetOnly;
+
+		/** One of the two is bound */
+		FPSPropertyChanged Delegate;
+		FPSPropertyChangedDynamic DynamicDelegate;
+
+		FDelegateHandle Handle;
+
+		bool IsStale() const
+		{
+			if (bTargetOnly ? !Target.IsValid() : !Class.IsValid())
+			{
+				return true;
+			}
+			return !Delegate.IsBound() && !DynamicDelegate.IsBound();
+		}
+
+		bool Matches(UObject* Object) const
+		{
+			if (bTargetOnly)
+			{
+				return Target.Get() == Object;
+			}
+			const UClass* ObservedClass = Cast<UClass>(Class.Get());
+			return ObservedClass && Object->IsA(ObservedClass);
+		}
+	};
+
+	struct FPSObserverStorage
+	{
+		FPSObserverStorage()
+		{
+			Bind();
+		}
+
+		void Bind()
+		{
+			if (!EndFrameHandle.IsValid())
+			{
+				EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FPSPropertyObservers::Dispatch);
+				PreExitHandle = FCoreDelegates::OnPreExit.AddStatic(&FPSPropertyObservers::Shutdown);
+			}
+		}
+
+		void Unbind()
+		{
+			FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+			FCoreDelegates::OnPreExit.Remove(PreExitHandle);
+			EndFrameHandle.Reset();
+			PreExitHandle.Reset();
+		}
+
+		FDelegateHandle EndFrameHandle;
+		FDelegateHandle PreExitHandle;
+
+		/** Game thread only */
+		TMap<FName, TArray<FPSObserver>> Observers;
+
+		/** Reports waiting for the end of the frame, and the same as a set so each goes in once */
+		FCriticalSection PendingLock;
+		TArray<TPair<FWeakObjectPtr, FName>> Pending;
+		TSet<TPair<const UObject*, FName>> PendingKeys;
+	};
+
+	FPSObserverStorage& GetStorage()
+	{
+		static FPSObserverStorage Storage;
+		return Storage;
+	}
+
+	FDelegateHandle AddObserver(FName VarName, FPSObserver&& Observer)
+	{
+		check(IsInGameThread());
+
+		Observer.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+		const FDelegateHandle Handle = Observer.Handle;
+
+		// Observing again after a shutdown starts dispatching again
+		FPSObserverStorage& Storage = GetStorage();
+		Storage.Bind();
+
+		TArray<FPSObserver>& List = Storage.Observers.FindOrAdd(VarName);
+		List.Add(MoveTemp(Observer));
+		if (List.Num() == 1)
+		{
+			FPSPropertyCache::SetObserved(VarName, true);
+		}
+		return Handle;
+	}
+
+	template<typename PredicateType>
+	void RemoveObservers(const PredicateType& Predicate)
+	{
+		check(IsInGameThread());
+
+		for (auto It = GetStorage().Observers.CreateIterator(); It; ++It)
+		{
+			It.Value().RemoveAll(Predicate);
+			if (It.Value().Num() == 0)
+			{
+				FPSPropertyCache::SetObserved(It.Key(), false);
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	FPSObserver MakeObjectObserver(UObject* Target)
+	{
+		FPSObserver Observer;
+		Observer.Target = Target;
+		Observer.bTargetOnly = true;
+		return Observer;
+	}
+
+	FPSObserver MakeClassObserver(const UClass* Class)
+	{
+		FPSObserver Observer;
+		Observer.Class = const_cast<UClass*>(Class);
+		Observer.bTargetOnly = false;
+		return Observer;
+	}
+}
+
+FDelegateHandle FPSPropertyObservers::ObserveObject(UObject* Target, FName VarName, FPSPropertyChanged Delegate)
+{
+	if (!Target || VarName.IsNone() || !Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	FPSObserver Observer = MakeObjectObserver(Target);
+	Observer.Delegate = MoveTemp(Delegate);
+	return AddObserver(VarName, MoveTemp(Observer));
+}
+
+FDelegateHandle FPSPropertyObservers::ObserveClass(const UClass* Class, FName VarName, FPSPropertyChanged Delegate)
+{
+	if (!Class || VarName.IsNone() || !Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	FPSObserver Observer = MakeClassObserver(Class);
+	Observer.Delegate = MoveTemp(Delegate);
+	return AddObserver(VarName, MoveTemp(Observer));
+}
+
+FDelegateHandle FPSPropertyObservers::ObserveObject(UObject* Target, FName VarName, const FPSPropertyChangedDynamic& Delegate)
+{
+	if (!Target || VarName.IsNone() || !Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	FPSObserver Observer = MakeObjectObserver(Target);
+	Observer.DynamicDelegate = Delegate;
+	return AddObserver(VarName, MoveTemp(Observer));
+}
+
+FDelegateHandle FPSPropertyObservers::ObserveClass(const UClass* Class, FName VarName, const FPSPropertyChangedDynamic& Delegate)
+{
+	if (!Class || VarName.IsNone() || !Delegate.IsBound())
+	{
+		return FDelegateHandle();
+	}
+
+	FPSObserver Observer = MakeClassObserver(Class);
+	Observer.DynamicDelegate = Delegate;
+	return AddObserver(VarName, MoveTemp(Observer));
+}
+
+void FPSPropertyObservers::Unobserve(FDelegateHandle Handle)
+{
+	if (Handle.IsValid())
+	{
+		RemoveObservers([Handle](const FPSObserver& Observer) { return Observer.Handle == Handle; });
+	}
+}
+
+void FPSPropertyObservers::Unobserve(const FPSPropertyChangedDynamic& Delegate)
+{
+	RemoveObservers([&Delegate](const FPSObserver& Observer) { return Observer.DynamicDelegate == Delegate; });
+}
+
+void FPSPropertyObservers::NotifyChanged(UObject* Target, FName VarName)
+{
+	FPSObserverStorage& Storage = GetStorage();
+	FScopeLock ScopeLock(&Storage.PendingLock);
+
+	bool bAlreadyPending = false;
+	Storage.PendingKeys.Add(TPair<const UObject*, FName>(Target, VarName), &bAlreadyPending);
+	if (!bAlreadyPending)
+	{
+		Storage.Pending.Emplace(FWeakObjectPtr(Target), VarName);
+	}
+}
+
+void FPSPropertyObservers::Dispatch()
+{
+	FPSObserverStorage& Storage = GetStorage();
+
+	TArray<TPair<FWeakObjectPtr, FName>> Reports;
+	{
+		FScopeLock ScopeLock(&Storage.PendingLock);
+		if (Storage.Pending.Num() == 0)
+		{
+			return;
+		}
+		Swap(Reports, Storage.Pending);
+		Storage.PendingKeys.Reset();
+	}
+
+	// Callbacks may observe, unobserve or write (which queues for next frame), so each list is copied before it's called
+	TArray<FPSObserver> Called;
+	for (const TPair<FWeakObjectPtr, FName>& Report : Reports)
+	{
+		UObject* Target = Report.Key.Get();
+		TArray<FPSObserver>* List = Storage.Observers.Find(Report.Value);
+		if (!Target || !List)
+		{
+			continue;
+		}
+
+		List->RemoveAll([](const FPSObserver& Observer) { return Observer.IsStale(); });
+		if (List->Num() == 0)
+		{
+			FPSPropertyCache::SetObserved(Report.Value, false);
+			Storage.Observers.Remove(Report.Value);
+			continue;
+		}
+
+		Called.Reset();
+		for (const FPSObserver& Observer : *List)
+		{
+			if (Observer.Matches(Target))
+			{
+				Called.Add(Observer);
+			}
+		}
+
+		for (const FPSObserver& Observer : Called)
+		{
+			if (Observer.Delegate.IsBound())
+			{
+				Observer.Delegate.Execute(Target, Report.Value);
+			}
+			else
+			{
+				Observer.DynamicDelegate.ExecuteIfBound(Target, Report.Value);
+			}
+		}
+	}
+}
+
+void FPSPropertyObservers::Shutdown()
+{
+	check(IsInGameThread());
+
+	FPSObserverStorage& Storage = GetStorage();
+	Storage.Unbind();
+
+	for (const TPair<FName, TArray<FPSObserver>>& Pair : Storage.Observers)
+	{
+		FPSPropertyCache::SetObserved(Pair.Key, false);
+	}
+	Storage.Observers.Reset();
+
+	FScopeLock ScopeLock(&Storage.PendingLock);
+	Storage.Pending.Reset();
+	Storage.PendingKeys.Reset();
+}
+
+FPSObservedWrite::FPSObservedWrite(UObject* InTarget, const UProperty* InProperty, bool bInObserved, bool bInJournaled)
+	: Target(InTarget)
+	, Property(nullptr)
+	, OldValue(nullptr)
+	, bObserved(bInObserved)
+	, bJournaled(bInJournaled && InProperty && InProperty->ArrayDim == 1)
+{
+	if (InProperty && (bObserved || bJournaled))
+	{
+		Property = InProperty;
+		OldValue = FMemory::Malloc(Property->GetSize(), Property->GetMinAlignment());
+		Property->InitializeValue(OldValue);
+		Property->CopyCompleteValue(OldValue, Property->ContainerPtrToValuePtr<void>(Target));
+	}
+}
+
+FPSObservedWrite::~FPSObservedWrite()
+{
+	if (!Property)
+	{
+		return;
+	}
+
+	const uint8* NewValue = Property->ContainerPtrToValuePtr<uint8>(Target);
+
+	if (bJournaled)
+	{
+		FPSJournal::RecordProperty(Target, Property, OldValue, NewValue);
+	}
+
+	if (bObserved)
+	{
+		for (int32 Index = 0; Index < Property->ArrayDim; ++Index)
+		{
+			const int32 Offset = Index * Property->ElementSize;
+			if (!Property->Identical((const uint8*)OldValue + Offset, NewValue + Offset))
+			{
+				FPSPropertyObservers::NotifyChanged(Target, Property->GetFName());
+				break;
+			}
+		}
+	}
+
+	Property->DestroyValue(OldValue);
+	FMemory::Free(OldValue);
+}
@@ -0,0 +1,77 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PSTypes.h"
+
+class UProperty;
+
+/** Called at the end of the frame in which an observed variable was changed through the UPSData setters. */
+DECLARE_DELEGATE_TwoParams(FPSPropertyChanged, UObject* /*Target*/, FName /*VarName*/);
+
+/**
+ * Change notifications for variables written through the UPSData setters.
+ *
+ * Observers are kept by variable name, and whether a name is observed at all is stored with the property cache entry the setters
+ * already look up, so writes nobody observes cost one flag check. Observed writes compare the value before and after and only
+ * report real changes. Reports are queued and handed out once at the end of the frame, at most one per target and variable however
+ * many times it changed, on the game thread. Setters may be called from any thread.
+ *
+ * The UPSData setters report, including CopyStructToObjectByNames and SetValuesFromStringByName, and so do FPSColumnFile loads.
+ * Bulk operations, columns, snapshots, imports, wire format and FPSLayoutSchema used directly write straight to memory.
+ * Observers of targets or classes that have been destroyed are dropped the next time their variable changes. Register and unregister
+ * on the game thread.
+ */
+struct NFPOPULATIONSYSTEM_API FPSPropertyObservers
+{
+	/** Calls Delegate when VarName changes on Target. */
+	static FDelegateHandle ObserveObject(UObject* Target, FName VarName, FPSPropertyChanged Delegate);
+
+	/** Calls Delegate when VarName changes on any object of Class (or a subclass). */
+	static FDelegateHandle ObserveClass(const UClass* Class, FName VarName, FPSPropertyChanged Delegate);
+
+	static FDelegateHandle ObserveObject(UObject* Target, FName VarName, const FPSPropertyChangedDynamic& Delegate);
+	static FDelegateHandle ObserveClass(const UClass* Class, FName VarName, const FPSPropertyChangedDynamic& Delegate);
+
+	static void Unobserve(FDelegateHandle Handle);
+
+	/** Removes every observer bound to Delegate's object and function. */
+	static void Unobserve(const FPSPropertyChangedDynamic& Delegate);
+
+	/** Queues a report for the end of the frame. Setters call this, only for variables that are observed. */
+	static void NotifyChanged(UObject* Target, FName VarName);
+
+	/** Hands out every queued report now. Runs by itself at the end of each frame. */
+	static void Dispatch();
+
+	/**
+	 * Unhooks from the end of frame and drops every observer and queued report. Runs by itself before the engine exits, call it
+	 * from the owning module's ShutdownModule as well so nothing is left bound to code that is being unloaded.
+	 */
+	static void Shutdown();
+};
+
+/**
+ * Snapshots a variable before a setter writes it, and on the way out of scope reports the write to FPSPropertyObservers if it
+ * changed the value. With bJournaled it also records the write to FPSJournal (variables that aren't static arrays only, entries have no
+ * element index). Does nothing at all for a variable that is neither observed nor journaled.
+ */
+class NFPOPULATIONSYSTEM_API FPSObservedWrite
+{
+public:
+
+	FPSObservedWrite(UObject* InTarget, const UProperty* InProperty, bool bInObserved, bool bInJournaled = false);
+	~FPSObservedWrite();
+
+	FPSObservedWrite(const FPSObservedWrite&) = delete;
+	FPSObservedWrite& operator=(const FPSObservedWrite&) = delete;
+
+private:
+
+	UObject* Target;
+	const UProperty* Property;
+	void* OldValue;
+	bool bObserved;
+	bool bJournaled;
+};
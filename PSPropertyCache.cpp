@@ -0,0 +1,426 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSPropertyCache.h"
+#include "PSTypes.h"
+
+#include "Misc/ScopeRWLock.h"
+#include "Templates/Atomic.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+	struct FPSPropertyCacheEntry
+	{
+		// Used to make sure the class the entry was made for hasn't been collected and its address reused
+		FWeakObjectPtr Class;
+
+		// Null for names the class doesn't have, so misses are remembered too
+		UProperty* Property;
+		FPSNumericAccess Numeric;
+		bool bObserved;
+	};
+
+	struct FPSDefaultValueEntry
+	{
+		FWeakObjectPtr Class;
+		UProperty* Property;
+		const void* Address;
+	};
+
+	struct FPSPropertyCacheStorage
+	{
+		FPSPropertyCacheStorage()
+			: Generation(0)
+			, ObserverGeneration(0)
+			, NumObservedNames(0)
+		{
+#if WITH_EDITOR
+			// Blueprint compiles and hot reloads reinstance classes, which moves their properties around
+			FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([this](const TMap<UObject*, UObject*>&)
+			{
+				Reset();
+			});
+#endif
+		}
+
+		void Reset()
+		{
+			FRWScopeLock ScopeLock(Lock, SLT_Write);
+			Entries.Reset();
+			DefaultValues.Reset();
+			++Generation;
+		}
+
+		FRWLock Lock;
+		TMap<TPair<const UClass*, FName>, FPSPropertyCacheEntry> Entries;
+		TMap<TPair<const UClass*, FName>, FPSDefaultValueEntry> DefaultValues;
+
+		/** Bumped on every reset. Atomic, as inline caches and the string caches check it without the lock */
+		TAtomic<uint32> Generation;
+
+		/** Names of the variables someone observes, by name so they outlive reinstancing */
+		TSet<FName> ObservedNames;
+
+		/** Bumped whenever ObservedNames changes, so inline caches pick up the new flags */
+		TAtomic<uint32> ObserverGeneration;
+
+		/** ObservedNames.Num(), readable without the lock */
+		TAtomic<int32> NumObservedNames;
+	};
+
+	FPSPropertyCacheStorage& GetStorage()
+	{
+		static FPSPropertyCacheStorage Storage;
+		return Storage;
+	}
+
+	EPSNumericKind GetNumericKind(const UProperty* Property)
+	{
+		if (const UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+		{
+			// Enum classes store their value in the underlying property, at the same address
+			Property = EnumProperty->GetUnderlyingProperty();
+		}
+
+		if (Property->IsA<UFloatProperty>())	return EPSNumericKind::Float;
+		if (Property->IsA<UDoubleProperty>())	return EPSNumericKind::Double;
+		if (Property->IsA<UInt8Property>())		return EPSNumericKind::Int8;
+		if (Property->IsA<UInt16Property>())	return EPSNumericKind::Int16;
+		if (Property->IsA<UIntProperty>())		return EPSNumericKind::Int32;
+		if (Property->IsA<UInt64Property>())	return EPSNumericKind::Int64;
+		if (Property->IsA<UByteProperty>())		return EPSNumericKind::UInt8;
+		if (Property->IsA<UUInt16Property>())	return EPSNumericKind::UInt16;
+		if (Property->IsA<UUInt32Property>())	return EPSNumericKind::UInt32;
+		if (Property->IsA<UUInt64Property>())	return EPSNumericKind::UInt64;
+		return EPSNumericKind::None;
+	}
+
+	// Entries each thread's string cache holds before it starts over
+	const int32 MaxStringCacheEntries = 1024;
+
+	struct FPSStringCacheEntry
+	{
+		FWeakObjectPtr Class;
+		FString VarName;
+		UProperty* Property;
+		uint32 Generation;
+	};
+
+	uint64 HashStringKey(const UClass* Class, const TCHAR* VarName, int32 VarNameLen)
+	{
+		// FNV-1a over the lower cased name, so lookups are case insensitive like FName
+		uint64 Hash = 14695981039346656037ull;
+		for (int32 Index = 0; Index < VarNameLen; ++Index)
+		{
+			Hash ^= (uint64)FChar::ToLower(VarName[Index]);
+			Hash *= 1099511628211ull;
+		}
+		return Hash ^ (uint64)(UPTRINT)Class;
+	}
+
+	bool FindEntry(const UClass* Class, FName VarName, FPSPropertyCacheEntry& OutEntry)
+	{
+		if (!Class || VarName.IsNone())
+		{
+			return false;
+		}
+
+		FPSPropertyCacheStorage& Storage = GetStorage();
+		const TPair<const UClass*, FName> Key(Class, VarName);
+
+		{
+			FRWScopeLock ScopeLock(Storage.Lock, SLT_ReadOnly);
+			if (const FPSPropertyCacheEntry* Entry = Storage.Entries.Find(Key))
+			{
+				if (Entry->Class.Get() == Class)
+				{
+					OutEntry = *Entry;
+					return OutEntry.Property != nullptr;
+				}
+			}
+		}
+
+		// Walks every super class before it can say no, which is what caching the misses saves
+		UProperty* Property = FindField<UProperty>(Class, VarName);
+
+		OutEntry.Class = const_cast<UClass*>(Class);
+		OutEntry.Property = Property;
+		OutEntry.Numeric.Offset = Property ? Property->GetOffset_ForInternal() : 0;
+		OutEntry.Numeric.Kind = (Property && Property->ArrayDim == 1) ? GetNumericKind(Property) : EPSNumericKind::None;
+
+		FRWScopeLock ScopeLock(Storage.Lock, SLT_Write);
+		OutEntry.bObserved = Property && Storage.ObservedNames.Contains(VarName);
+		Storage.Entries.Add(Key, OutEntry);
+		return Property != nullptr;
+	}
+}
+
+UProperty* FPSPropertyCache::FindProperty(const UClass* Class, FName VarName)
+{
+	FPSPropertyCacheEntry Entry;
+	return FindEntry(Class, VarName, Entry) ? Entry.Property : nullptr;
+}
+
+UProperty* FPSPropertyCache::FindProperty(const UClass* Class, FName VarName, bool& bOutObserved)
+{
+	FPSPropertyCacheEntry Entry;
+	const bool bFound = FindEntry(Class, VarName, Entry);
+	bOutObserved = bFound && Entry.bObserved;
+	return bFound ? Entry.Property : nullptr;
+}
+
+UProperty* FPSPropertyCache::FindProperty(const UClass* Class, FName VarName, FPSInlineCache& Cache)
+{
+	bool bObserved = false;
+	return FindProperty(Class, VarName, Cache, bObserved);
+}
+
+UProperty* FPSPropertyCache::FindProperty(const UClass* Class, FName VarName, FPSInlineCache& Cache, bool& bOutObserved)
+{
+	const FPSPropertyCacheStorage& Storage = GetStorage();
+	const uint32 Generation = Storage.Generation.Load();
+	const uint32 ObserverGeneration = Storage.ObserverGeneration.Load();
+	if (Cache.Generation != Generation || Cache.ObserverGeneration != ObserverGeneration)
+	{
+		// Properties may have moved or their flags changed, start over (including call sites that had given up on caching)
+		Cache = FPSInlineCache();
+		Cache.Generation = Generation;
+		Cache.ObserverGeneration = ObserverGeneration;
+	}
+
+	if (!Cache.bMegamorphic)
+	{
+		for (int32 Index = 0; Index < Cache.NumUsed; ++Index)
+		{
+			const FPSInlineCache::FEntry& Entry = Cache.Entries[Index];
+			if (Entry.VarName == VarName && Entry.Class.Get() == Class)
+			{
+				bOutObserved = Entry.bObserved;
+				return Entry.Property;
+			}
+		}
+	}
+
+	UProperty* Property = FindProperty(Class, VarName, bOutObserved);
+
+	// Misses go in as well, a call site probing classes without the variable keeps finding that out here
+	if (!Cache.bMegamorphic)
+	{
+		if (Cache.NumUsed < FPSInlineCache::NumEntries)
+		{
+			FPSInlineCache::FEntry& NewEntry = Cache.Entries[Cache.NumUsed++];
+			NewEntry.Class = const_cast<UClass*>(Class);
+			NewEntry.VarName = VarName;
+			NewEntry.Property = Property;
+			NewEntry.bObserved = bOutObserved;
+		}
+		else
+		{
+			// Too many classes through here, checking the entries first would only add to the cost of every call
+			Cache.bMegamorphic = true;
+		}
+	}
+
+	return Property;
+}
+
+UProperty* FPSPropertyCache::FindPropertyByString(const UClass* Class, const TCHAR* VarName, int32 VarNameLen)
+{
+	if (!Class || !VarName || VarNameLen <= 0)
+	{
+		return nullptr;
+	}
+
+	static thread_local TMap<uint64, FPSStringCacheEntry> StringCache;
+
+	const uint64 Key = HashStringKey(Class, VarName, VarNameLen);
+	const uint32 Generation = GetGeneration();
+
+	if (const FPSStringCacheEntry* Entry = StringCache.Find(Key))
+	{
+		if (Entry->Generation == Generation
+			&& Entry->Class.Get() == Class
+			&& Entry->VarName.Len() == VarNameLen
+			&& FCString::Strnicmp(*Entry->VarName, VarName, VarNameLen) == 0)
+		{
+			return Entry->Property;
+		}
+	}
+
+	// Only look the name up, never add it. If the table doesn't know the name, no property can have it.
+	const FString NameString(VarNameLen, VarName);
+	const FName Name(*NameString, FNAME_Find);
+	UProperty* Property = Name.IsNone() ? nullptr : FindProperty(Class, Name);
+
+	if (StringCache.Num() >= MaxStringCacheEntries)
+	{
+		StringCache.Reset();
+	}
+
+	FPSStringCacheEntry& NewEntry = StringCache.Add(Key);
+	NewEntry.Class = const_cast<UClass*>(Class);
+	NewEntry.VarName = NameString;
+	NewEntry.Property = Property;
+	NewEntry.Generation = Generation;
+
+	return Property;
+}
+
+bool FPSPropertyCache::FindNumeric(const UClass* Class, FName VarName, FPSNumericAccess& OutAccess)
+{
+	FPSPropertyCacheEntry Entry;
+	if (FindEntry(Class, VarName, Entry) && Entry.Numeric.Kind != EPSNumericKind::None)
+	{
+		OutAccess = Entry.Numeric;
+		return true;
+	}
+	return false;
+}
+
+bool FPSPropertyCache::FindDefaultValue(const UClass* Class, FName VarName, UProperty*& OutProperty, const void*& OutAddress)
+{
+	if (!Class || VarName.IsNone())
+	{
+		return false;
+	}
+
+	FPSPropertyCacheStorage& Storage = GetStorage();
+	const TPair<const UClass*, FName> Key(Class, VarName);
+
+	{
+		FRWScopeLock ScopeLock(Storage.Lock, SLT_ReadOnly);
+		if (const FPSDefaultValueEntry* Entry = Storage.DefaultValues.Find(Key))
+		{
+			if (Entry->Class.Get() == Class)
+			{
+				OutProperty = Entry->Property;
+				OutAddress = Entry->Address;
+				return true;
+			}
+		}
+	}
+
+	UProperty* Property = FindProperty(Class, VarName);
+	if (!Property)
+	{
+		return false;
+	}
+
+	// May construct the CDO, so do it outside the lock
+	const UObject* DefaultObject = const_cast<UClass*>(Class)->GetDefaultObject();
+	if (!DefaultObject)
+	{
+		return false;
+	}
+
+	FPSDefaultValueEntry NewEntry;
+	NewEntry.Class = const_cast<UClass*>(Class);
+	NewEntry.Property = Property;
+	NewEntry.Address = Property->ContainerPtrToValuePtr<void>(DefaultObject);
+
+	OutProperty = NewEntry.Property;
+	OutAddress = NewEntry.Address;
+
+	FRWScopeLock ScopeLock(Storage.Lock, SLT_Write);
+	Storage.DefaultValues.Add(Key, NewEntry);
+	return true;
+}
+
+int32 FPSPropertyCache::ResolveValueAddresses(const TArray<UObject*>& Targets, FName VarName, const UClass* PropertyClass, TArray<void*>& OutAddresses)
+{
+	OutAddresses.SetNumUninitialized(Targets.Num());
+
+	int32 NumResolved = 0;
+	const UClass* LastClass = nullptr;
+	UProperty* LastProperty = nullptr;
+
+	for (int32 Index = 0; Index < Targets.Num(); ++Index)
+	{
+		UObject* Target = Targets[Index];
+		OutAddresses[Index] = nullptr;
+
+		if (!Target)
+		{
+			continue;
+		}
+
+		const UClass* Class = Target->GetClass();
+		if (Class != LastClass)
+		{
+			LastClass = Class;
+			LastProperty = FindProperty(Class, VarName);
+			if (LastProperty && (!LastProperty->IsA(PropertyClass) || LastProperty->ArrayDim != 1))
+			{
+				LastProperty = nullptr;
+			}
+		}
+
+		if (LastProperty)
+		{
+			OutAddresses[Index] = LastProperty->ContainerPtrToValuePtr<void>(Target);
+			++NumResolved;
+		}
+	}
+
+	return NumResolved;
+}
+
+EPSNumericKind FPSPropertyCache::GetNumericKind(const UProperty* Property)
+{
+	return Property ? ::GetNumericKind(Property) : EPSNumericKind::None;
+}
+
+void FPSPropertyCache::SetObserved(FName VarName, bool bObserved)
+{
+	FPSPropertyCacheStorage& Storage = GetStorage();
+	FRWScopeLock ScopeLock(Storage.Lock, SLT_Write);
+
+	if (bObserved)
+	{
+		Storage.ObservedNames.Add(VarName);
+	}
+	else
+	{
+		Storage.ObservedNames.Remove(VarName);
+	}
+	Storage.NumObservedNames = Storage.ObservedNames.Num();
+
+	// Existing entries are updated in place rather than dropped, nothing else about them changed
+	for (TPair<TPair<const UClass*, FName>, FPSPropertyCacheEntry>& Pair : Storage.Entries)
+	{
+		if (Pair.Key.Value == VarName)
+		{
+			Pair.Value.bObserved = bObserved && Pair.Value.Property;
+		}
+	}
+
+	++Storage.ObserverGeneration;
+}
+
+bool FPSPropertyCache::IsObserved(FName VarName)
+{
+	FPSPropertyCacheStorage& Storage = GetStorage();
+	if (Storage.NumObservedNames.Load() == 0)
+	{
+		return false;
+	}
+
+	FRWScopeLock ScopeLock(Storage.Lock, SLT_ReadOnly);
+	return Storage.ObservedNames.Contains(VarName);
+}
+
+bool FPSPropertyCache::IsAnyObserved()
+{
+	return GetStorage().NumObservedNames.Load() != 0;
+}
+
+void FPSPropertyCache::Invalidate()
+{
+	GetStorage().Reset();
+}
+
+uint32 FPSPropertyCache::GetGeneration()
+{
+	return GetStorage().Generation.Load();
+}
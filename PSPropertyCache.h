@@ -0,0 +1,189 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/IsFloatingPoint.h"
+#include "Templates/IsIntegral.h"
+#include "UObject/UnrealType.h"
+
+struct FPSInlineCache;
+
+/** How a numeric property is stored, so it can be read and converted without going through the property. */
+enum class EPSNumericKind : uint8
+{
+	None,
+	Float,
+	Double,
+	Int8,
+	Int16,
+	Int32,
+	Int64,
+	UInt8,
+	UInt16,
+	UInt32,
+	UInt64
+};
+
+/** Resolved location and storage type of a numeric variable. Reading one is a switch and a load, no property lookups. */
+struct FPSNumericAccess
+{
+	int32 Offset = 0;
+	EPSNumericKind Kind = EPSNumericKind::None;
+
+	/**
+	 * Value as ToType. Floating point values going into an int saturate to its range (NaN becomes 0), where a plain cast would be
+	 * undefined; within range they truncate towards zero. Every other conversion is a C cast.
+	 */
+	template<typename ToType, typename FromType>
+	static FORCEINLINE ToType Convert(FromType Value)
+	{
+		if (TIsFloatingPoint<FromType>::Value && TIsIntegral<ToType>::Value)
+		{
+			// One past the largest value is a power of two, so exact as a double even where the largest value itself isn't
+			const double Lowest = (double)TNumericLimits<ToType>::Lowest();
+			const double UpperBound = (double)TNumericLimits<ToType>::Max() + 1.0;
+			if (Value != Value)
+			{
+				return (ToType)0;
+			}
+			if ((double)Value <= Lowest)
+			{
+				return TNumericLimits<ToType>::Lowest();
+			}
+			if ((double)Value >= UpperBound)
+			{
+				return TNumericLimits<ToType>::Max();
+			}
+		}
+		return (ToType)Value;
+	}
+
+	template<typename ValueType>
+	FORCEINLINE ValueType Read(const UObject* Object) const
+	{
+		const uint8* Address = reinterpret_cast<const uint8*>(Object) + Offset;
+		switch (Kind)
+		{
+		case EPSNumericKind::Float:		return Convert<ValueType>(*reinterpret_cast<const float*>(Address));
+		case EPSNumericKind::Double:	return Convert<ValueType>(*reinterpret_cast<const double*>(Address));
+		case EPSNumericKind::Int8:		return (ValueType)*reinterpret_cast<const int8*>(Address);
+		case EPSNumericKind::Int16:		return (ValueType)*reinterpret_cast<const int16*>(Address);
+		case EPSNumericKind::Int32:		return (ValueType)*reinterpret_cast<const int32*>(Address);
+		case EPSNumericKind::Int64:		return (ValueType)*reinterpret_cast<const int64*>(Address);
+		case EPSNumericKind::UInt8:		return (ValueType)*reinterpret_cast<const uint8*>(Address);
+		case EPSNumericKind::UInt16:	return (ValueType)*reinterpret_cast<const uint16*>(Address);
+		case EPSNumericKind::UInt32:	return (ValueType)*reinterpret_cast<const uint32*>(Address);
+		case EPSNumericKind::UInt64:	return (ValueType)*reinterpret_cast<const uint64*>(Address);
+		default:						return (ValueType)0;
+		}
+	}
+
+	/** Stores Value converted to the variable's own type, see Convert(). */
+	template<typename ValueType>
+	FORCEINLINE void Write(UObject* Object, ValueType Value) const
+	{
+		uint8* Address = reinterpret_cast<uint8*>(Object) + Offset;
+		switch (Kind)
+		{
+		case EPSNumericKind::Float:		*reinterpret_cast<float*>(Address) = (float)Value; break;
+		case EPSNumericKind::Double:	*reinterpret_cast<double*>(Address) = (double)Value; break;
+		case EPSNumericKind::Int8:		*reinterpret_cast<int8*>(Address) = Convert<int8>(Value); break;
+		case EPSNumericKind::Int16:		*reinterpret_cast<int16*>(Address) = Convert<int16>(Value); break;
+		case EPSNumericKind::Int32:		*reinterpret_cast<int32*>(Address) = Convert<int32>(Value); break;
+		case EPSNumericKind::Int64:		*reinterpret_cast<int64*>(Address) = Convert<int64>(Value); break;
+		case EPSNumericKind::UInt8:		*reinterpret_cast<uint8*>(Address) = Convert<uint8>(Value); break;
+		case EPSNumericKind::UInt16:	*reinterpret_cast<uint16*>(Address) = Convert<uint16>(Value); break;
+		case EPSNumericKind::UInt32:	*reinterpret_cast<uint32*>(Address) = Convert<uint32>(Value); break;
+		case EPSNumericKind::UInt64:	*reinterpret_cast<uint64*>(Address) = Convert<uint64>(Value); break;
+		default:						break;
+		}
+	}
+};
+
+/**
+ * Per-class cache of resolved properties.
+ * Saves walking the whole field chain of a class (and its supers) every time something asks for a variable by name.
+ * Names a class doesn't have are cached as well, so probing many classes for an optional variable is a hash lookup per class.
+ * Entries are dropped whenever classes get reinstanced (Blueprint recompile, hot reload).
+ */
+struct NFPOPULATIONSYSTEM_API FPSPropertyCache
+{
+	/** Finds the property named VarName on Class or one of its super classes. */
+	static UProperty* FindProperty(const UClass* Class, FName VarName);
+
+	/** Same as above, but only returns the property if it is of the requested type. */
+	template<typename PropertyType>
+	static PropertyType* FindProperty(const UClass* Class, FName VarName)
+	{
+		return Cast<PropertyType>(FindProperty(Class, VarName));
+	}
+
+	/** Same as FindProperty, also saying whether writes to the variable have to be reported to FPSPropertyObservers. */
+	static UProperty* FindProperty(const UClass* Class, FName VarName, bool& bOutObserved);
+
+	template<typename PropertyType>
+	static PropertyType* FindProperty(const UClass* Class, FName VarName, bool& bOutObserved)
+	{
+		return Cast<PropertyType>(FindProperty(Class, VarName, bOutObserved));
+	}
+
+	/** Same as FindProperty, but checks (and fills) the call site's inline cache before the shared one. */
+	static UProperty* FindProperty(const UClass* Class, FName VarName, FPSInlineCache& Cache);
+	static UProperty* FindProperty(const UClass* Class, FName VarName, FPSInlineCache& Cache, bool& bOutObserved);
+
+	/**
+	 * Finds a property from a runtime built name (e.g. "Skill_" + Index) without constructing an FName for it.
+	 * Each thread keeps a small bounded cache keyed on the string's hash, so repeated names skip the global name table (and its lock).
+	 * Matching is case insensitive, like FName.
+	 */
+	static UProperty* FindPropertyByString(const UClass* Class, const TCHAR* VarName, int32 VarNameLen);
+
+	static UProperty* FindPropertyByString(const UClass* Class, const FString& VarName)
+	{
+		return FindPropertyByString(Class, *VarName, VarName.Len());
+	}
+
+	/**
+	 * Finds VarName on Class if it is a single numeric value of any width (float, double, signed/unsigned ints, bytes and enums).
+	 * The storage type is worked out once and kept with the cached entry, so repeated reads skip the type dispatch on the property.
+	 */
+	static bool FindNumeric(const UClass* Class, FName VarName, FPSNumericAccess& OutAccess);
+
+	/**
+	 * Finds VarName on Class and the address of its value inside the class default object.
+	 * The address is cached per class, so reading tuning constants off the CDO costs one cache lookup and a load.
+	 * It stays valid until the class is reinstanced, which invalidates the cache.
+	 */
+	static bool FindDefaultValue(const UClass* Class, FName VarName, UProperty*& OutProperty, const void*& OutAddress);
+
+	/**
+	 * Resolves the address of VarName inside each target, for a whole batch at once.
+	 * Consecutive targets of the same class share one lookup. Entries are nullptr where the target is null,
+	 * lacks the property, or the property isn't a single PropertyClass value.
+	 *
+	 * @return	How many addresses were resolved.
+	 */
+	static int32 ResolveValueAddresses(const TArray<UObject*>& Targets, FName VarName, const UClass* PropertyClass, TArray<void*>& OutAddresses);
+
+	/** How Property stores its value if it is numeric (enums by their underlying type), None otherwise. Works for struct members as well. */
+	static EPSNumericKind GetNumericKind(const UProperty* Property);
+
+	/**
+	 * Flags every variable named VarName as observed or not, on every class. The flag is kept with the cached entries,
+	 * so a setter finds out whether anyone is watching from the lookup it does anyway. Observed names survive Invalidate().
+	 */
+	static void SetObserved(FName VarName, bool bObserved);
+
+	/** For writes that don't go through a cached entry. Free while nothing at all is observed. */
+	static bool IsObserved(FName VarName);
+
+	/** Whether any variable is observed, for writers that would have to work out names before they can ask IsObserved. */
+	static bool IsAnyObserved();
+
+	/** Drops every cached entry. */
+	static void Invalidate();
+
+	/** Bumped on every Invalidate(), so caches built on top of this one can tell when they are stale. */
+	static uint32 GetGeneration();
+};
@@ -0,0 +1,267 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSSnapshot.h"
+
+#include "PSPropertyCache.h"
+
+FPSSnapshot::FPSSnapshot()
+	: Generation(0)
+{
+}
+
+FPSSnapshot::~FPSSnapshot()
+{
+	Reset();
+}
+
+void FPSSnapshot::Capture(const TArray<UObject*>& Targets, const TArray<FName>& InVarNames)
+{
+	Reset();
+
+	VarNames = InVarNames;
+	Generation = FPSPropertyCache::GetGeneration();
+
+	// Lay out every row first so the buffer is allocated once, non-POD values can't be moved after they're constructed
+	Rows.Reserve(Targets.Num());
+
+	int32 BufferSize = 0;
+	const UClass* LastClass = nullptr;
+	int32 LastLayoutIndex = INDEX_NONE;
+
+	for (UObject* Target : Targets)
+	{
+		FRow& Row = Rows.AddDefaulted_GetRef();
+		Row.Object = Target;
+		Row.LayoutIndex = INDEX_NONE;
+		Row.Offset = 0;
+
+		if (!Target)
+		{
+			continue;
+		}
+
+		if (Target->GetClass() != LastClass)
+		{
+			LastClass = Target->GetClass();
+			LastLayoutIndex = FindOrAddLayout(LastClass);
+		}
+
+		Row.LayoutIndex = LastLayoutIndex;
+		Row.Offset = BufferSize;
+		BufferSize += Layouts[LastLayoutIndex].RowSize;
+	}
+
+	Buffer.SetNumZeroed(BufferSize);
+
+	// Non-POD values need constructing before they can be copied into
+	for (const FRow& Row : Rows)
+	{
+		if (Row.LayoutIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FLayout& Layout = Layouts[Row.LayoutIndex];
+		if (!Layout.bNeedsDestruction)
+		{
+			continue;
+		}
+
+		for (int32 VarIndex = 0; VarIndex < Layout.Properties.Num(); ++VarIndex)
+		{
+			if (UProperty* Property = Layout.Properties[VarIndex])
+			{
+				Property->InitializeValue(Buffer.GetData() + Row.Offset + Layout.Offsets[VarIndex]);
+			}
+		}
+	}
+
+	CopyValuesIn();
+}
+
+void FPSSnapshot::Recapture()
+{
+	if (IsStale())
+	{
+		TArray<UObject*> Targets;
+		Targets.Reserve(Rows.Num());
+		for (const FRow& Row : Rows)
+		{
+			Targets.Add(Row.Object.Get());
+		}
+
+		TArray<FName> OldVarNames = VarNames;
+		Capture(Targets, OldVarNames);
+		return;
+	}
+
+	CopyValuesIn();
+}
+
+int32 FPSSnapshot::Diff(TArray<FPSChangeRecord>& OutChanges) const
+{
+	if (IsStale())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 NumBefore = OutChanges.Num();
+
+	for (int32 ObjectIndex = 0; ObjectIndex < Rows.Num(); ++ObjectIndex)
+	{
+		const FRow& Row = Rows[ObjectIndex];
+		UObject* Object = Row.Object.Get();
+		if (!Object || Row.LayoutIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FLayout& Layout = Layouts[Row.LayoutIndex];
+		const uint8* RowData = Buffer.GetData() + Row.Offset;
+
+		for (int32 VarIndex = 0; VarIndex < Layout.Properties.Num(); ++VarIndex)
+		{
+			const UProperty* Property = Layout.Properties[VarIndex];
+			if (!Property)
+			{
+				continue;
+			}
+
+			const void* Stored = RowData + Layout.Offsets[VarIndex];
+			const void* Current = Property->ContainerPtrToValuePtr<void>(Object);
+
+			bool bChanged;
+			if (Layout.UseMemcmp[VarIndex])
+			{
+				bChanged = FMemory::Memcmp(Stored, Current, Property->GetSize()) != 0;
+			}
+			else
+			{
+				bChanged = false;
+				for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim && !bChanged; ++ArrayIndex)
+				{
+					const int32 ElementOffset = ArrayIndex * Property->ElementSize;
+					bChanged = !Property->Identical((const uint8*)Stored + ElementOffset, (const uint8*)Current + ElementOffset, PPF_None);
+				}
+			}
+
+			if (bChanged)
+			{
+				FPSChangeRecord Change;
+				Change.ObjectIndex = ObjectIndex;
+				Change.VarIndex = VarIndex;
+				OutChanges.Add(Change);
+			}
+		}
+	}
+
+	return OutChanges.Num() - NumBefore;
+}
+
+void FPSSnapshot::Reset()
+{
+	DestroyValues();
+
+	VarNames.Reset();
+	Layouts.Reset();
+	Rows.Reset();
+	Buffer.Reset();
+}
+
+bool FPSSnapshot::IsStale() const
+{
+	return Generation != FPSPropertyCache::GetGeneration();
+}
+
+int32 FPSSnapshot::FindOrAddLayout(const UClass* Class)
+{
+	for (int32 LayoutIndex = 0; LayoutIndex < Layouts.Num(); ++LayoutIndex)
+	{
+		if (Layouts[LayoutIndex].Class.Get() == Class)
+		{
+			return LayoutIndex;
+		}
+	}
+
+	FLayout& Layout = Layouts.AddDefaulted_GetRef();
+	Layout.Class = Class;
+	Layout.RowSize = 0;
+	Layout.bNeedsDestruction = false;
+
+	for (const FName& VarName : VarNames)
+	{
+		UProperty* Property = FPSPropertyCache::FindProperty(Class, VarName);
+
+		int32 Offset = 0;
+		bool bUseMemcmp = false;
+		if (Property)
+		{
+			Offset = Align(Layout.RowSize, Property->GetMinAlignment());
+			Layout.RowSize = Offset + Property->GetSize();
+
+			// Bitfield bools share their byte with other flags, so they can't be compared as raw memory
+			bUseMemcmp = Property->HasAnyPropertyFlags(CPF_IsPlainOldData) && !Property->IsA<UBoolProperty>();
+			Layout.bNeedsDestruction |= !Property->HasAnyPropertyFlags(CPF_IsPlainOldData | CPF_NoDestructor);
+		}
+
+		Layout.Properties.Add(Property);
+		Layout.Offsets.Add(Offset);
+		Layout.UseMemcmp.Add(bUseMemcmp);
+	}
+
+	// Keep every row starting on a 16 byte boundary so any member alignment holds
+	Layout.RowSize = Align(Layout.RowSize, 16);
+
+	return Layouts.Num() - 1;
+}
+
+void FPSSnapshot::CopyValuesIn()
+{
+	for (const FRow& Row : Rows)
+	{
+		UObject* Object = Row.Object.Get();
+		if (!Object || Row.LayoutIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FLayout& Layout = Layouts[Row.LayoutIndex];
+		uint8* RowData = Buffer.GetData() + Row.Offset;
+
+		for (int32 VarIndex = 0; VarIndex < Layout.Properties.Num(); ++VarIndex)
+		{
+			if (const UProperty* Property = Layout.Properties[VarIndex])
+			{
+				Property->CopyCompleteValue(RowData + Layout.Offsets[VarIndex], Property->ContainerPtrToValuePtr<void>(Object));
+			}
+		}
+	}
+}
+
+void FPSSnapshot::DestroyValues()
+{
+	for (const FRow& Row : Rows)
+	{
+		if (Row.LayoutIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const FLayout& Layout = Layouts[Row.LayoutIndex];
+
+		// If the class is gone its properties may be too, leaking the copies is safer than touching them
+		if (!Layout.bNeedsDestruction || !Layout.Class.IsValid())
+		{
+			continue;
+		}
+
+		for (int32 VarIndex = 0; VarIndex < Layout.Properties.Num(); ++VarIndex)
+		{
+			if (UProperty* Property = Layout.Properties[VarIndex])
+			{
+				Property->DestroyValue(Buffer.GetData() + Row.Offset + Layout.Offsets[VarIndex]);
+			}
+		}
+	}
+}
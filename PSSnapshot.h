@@ -0,0 +1,89 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UnrealType.h"
+#include "UObject/WeakObjectPtr.h"
+
+/** One value that differs between a snapshot and the live object. */
+struct FPSChangeRecord
+{
+	/** Index of the object in the array the snapshot was captured from. */
+	int32 ObjectIndex;
+
+	/** Index of the variable in the name list the snapshot was captured with. */
+	int32 VarIndex;
+};
+
+/**
+ * Captures a list of named variables across an array of objects into one packed buffer,
+ * and later reports which of them changed on which objects.
+ * Variables are resolved once per class. Plain old data is compared with memcmp, everything else through UProperty::Identical.
+ */
+class NFPOPULATIONSYSTEM_API FPSSnapshot
+{
+public:
+
+	FPSSnapshot();
+	~FPSSnapshot();
+
+	FPSSnapshot(const FPSSnapshot&) = delete;
+	FPSSnapshot& operator=(const FPSSnapshot&) = delete;
+
+	/** Throws away any previous capture and stores the current value of each of VarNames on each of Targets. */
+	void Capture(const TArray<UObject*>& Targets, const TArray<FName>& InVarNames);
+
+	/** Stores the current values again, for the same objects and variables. Use this after a checkpoint. */
+	void Recapture();
+
+	/**
+	 * Appends a record for every captured value that no longer matches the live object.
+	 * Objects that were destroyed since the capture are skipped.
+	 *
+	 * @return	Number of records added, or INDEX_NONE if the snapshot is stale (classes were reinstanced) and has to be captured again.
+	 */
+	int32 Diff(TArray<FPSChangeRecord>& OutChanges) const;
+
+	void Reset();
+
+	bool IsStale() const;
+
+	int32 NumObjects() const { return Rows.Num(); }
+	UObject* GetObject(int32 ObjectIndex) const { return Rows[ObjectIndex].Object.Get(); }
+	FName GetVarName(int32 VarIndex) const { return VarNames[VarIndex]; }
+
+private:
+
+	/** Where each variable lives inside a row, for one class. */
+	struct FLayout
+	{
+		TWeakObjectPtr<const UClass> Class;
+
+		/** Per variable, nullptr when the class doesn't have it. */
+		TArray<UProperty*> Properties;
+		TArray<int32> Offsets;
+		TArray<bool> UseMemcmp;
+
+		int32 RowSize;
+		bool bNeedsDestruction;
+	};
+
+	struct FRow
+	{
+		TWeakObjectPtr<UObject> Object;
+		int32 LayoutIndex;
+		int32 Offset;
+	};
+
+	int32 FindOrAddLayout(const UClass* Class);
+	void CopyValuesIn();
+	void DestroyValues();
+
+	TArray<FName> VarNames;
+	TArray<FLayout> Layouts;
+	TArray<FRow> Rows;
+	TArray<uint8, TAlignedHeapAllocator<16>> Buffer;
+
+	uint32 Generation;
+};
@@ -0,0 +1,601 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSTableImport.h"
+
+#include "PSPropertyCache.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	// The file is read and applied this much at a time
+	const int32 ReadChunkSize = 64 * 1024;
+
+	// Longest number the float parser takes, longer cells can't be a sensible float anyway
+	const int32 MaxFloatLength = 63;
+
+	/** Where a cell sits in the pending text, quotes already taken out. */
+	struct FCell
+	{
+		int32 Begin;
+		int32 Len;
+	};
+
+	/** How one header column goes into one class. */
+	struct FColumnBinding
+	{
+		/** Null if the class has no single value variable of that name, the column is skipped */
+		UProperty* Property = nullptr;
+
+		/** Kind is None unless the variable is a number (or an enum) */
+		FPSNumericAccess Numeric;
+
+		/** Enums also take their value names, through the property */
+		bool bEnum = false;
+	};
+
+	bool IsFloatingPoint(EPSNumericKind Kind)
+	{
+		return Kind == EPSNumericKind::Float || Kind == EPSNumericKind::Double;
+	}
+
+	void TrimCell(const ANSICHAR*& Begin, int32& Len)
+	{
+		while (Len > 0 && (*Begin == ' ' || *Begin == '\t'))
+		{
+			++Begin;
+			--Len;
+		}
+		while (Len > 0 && (Begin[Len - 1] == ' ' || Begin[Len - 1] == '\t'))
+		{
+			--Len;
+		}
+	}
+
+	// Out of range values wrap like a C cast into the variable's type
+	bool ParseInt(const ANSICHAR* Begin, int32 Len, int64& OutValue)
+	{
+		TrimCell(Begin, Len);
+
+		int32 Index = 0;
+		const bool bNegative = Len > 0 && Begin[0] == '-';
+		if (Len > 0 && (Begin[0] == '-' || Begin[0] == '+'))
+		{
+			++Index;
+		}
+
+		if (Index == Len)
+		{
+			return false;
+		}
+
+		uint64 Value = 0;
+		for (; Index < Len; ++Index)
+		{
+			const ANSICHAR Char = Begin[Index];
+			if (Char < '0' || Char > '9')
+			{
+				return false;
+			}
+			Value = Value * 10 + (uint64)(Char - '0');
+		}
+
+		OutValue = (int64)(bNegative ? 0 - Value : Value);
+		return true;
+	}
+
+	bool ParseFloat(const ANSICHAR* Begin, int32 Len, double& OutValue)
+	{
+		TrimCell(Begin, Len);
+		if (Len == 0 || Len > MaxFloatLength)
+		{
+			return false;
+		}
+
+		// Atod stops quietly at the first character it doesn't like, so check them all first
+		bool bHasDigit = false;
+		ANSICHAR Buffer[MaxFloatLength + 1];
+		for (int32 Index = 0; Index < Len; ++Index)
+		{
+			const ANSICHAR Char = Begin[Index];
+			if (Char >= '0' && Char <= '9')
+			{
+				bHasDigit = true;
+			}
+			else if (Char != '-' && Char != '+' && Char != '.' && Char != 'e' && Char != 'E')
+			{
+				return false;
+			}
+			Buffer[Index] = Char;
+		}
+		Buffer[Len] = 0;
+
+		if (!bHasDigit)
+		{
+			return false;
+		}
+
+		OutValue = FCStringAnsi::Atod(Buffer);
+		return true;
+	}
+
+	bool ParseBool(const ANSICHAR* Begin, int32 Len, bool& OutValue)
+	{
+		TrimCell(Begin, Len);
+
+		static const ANSICHAR* const TrueWords[] = { "true", "yes", "1" };
+		static const ANSICHAR* const FalseWords[] = { "false", "no", "0" };
+
+		for (const ANSICHAR* Word : TrueWords)
+		{
+			if (FCStringAnsi::Strlen(Word) == Len && FCStringAnsi::Strnicmp(Begin, Word, Len) == 0)
+			{
+				OutValue = true;
+				return true;
+			}
+		}
+		for (const ANSICHAR* Word : FalseWords)
+		{
+			if (FCStringAnsi::Strlen(Word) == Len && FCStringAnsi::Strnicmp(Begin, Word, Len) == 0)
+			{
+				OutValue = false;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	class FPSTableImporter
+	{
+	public:
+
+		FPSTableImporter(const TArray<UObject*>& InTargets, TCHAR InDelimiter, FPSTableImportResult& InResult)
+			: Targets(InTargets)
+			, Result(InResult)
+			, Delimiter((ANSICHAR)InDelimiter)
+			, RowNumber(0)
+			, HeaderRow(0)
+			, FirstExtraRow(0)
+			, NumExtraRows(0)
+			, bCheckedByteOrderMark(false)
+			, bHasHeader(false)
+			, LastClass(nullptr)
+			, LastBindings(nullptr)
+		{
+		}
+
+		/** Takes the next piece of the text and applies every row it completes. */
+		void Feed(const ANSICHAR* Data, int32 Num)
+		{
+			Pending.Append(Data, Num);
+			ParsePending(false);
+		}
+
+		/** Applies whatever is left, the last row needing no line break. */
+		bool Finish()
+		{
+			ParsePending(true);
+
+			if (NumExtraRows > 0)
+			{
+				AddError(FirstExtraRow, 0, FString::Printf(TEXT("%d rows past the last of the %d targets were ignored"), NumExtraRows, Targets.Num()));
+			}
+
+			return bHasHeader;
+		}
+
+	private:
+
+		void ParsePending(bool bFinal)
+		{
+			int32 Pos = 0;
+
+			if (!bCheckedByteOrderMark)
+			{
+				if (Pending.Num() < 3 && !bFinal)
+				{
+					return;
+				}
+
+				bCheckedByteOrderMark = true;
+				if (Pending.Num() >= 3 && (uint8)Pending[0] == 0xEF && (uint8)Pending[1] == 0xBB && (uint8)Pending[2] == 0xBF)
+				{
+					Pos = 3;
+				}
+			}
+
+			int32 RowEnd = 0;
+			int32 NextRow = 0;
+			while (FindRowEnd(Pos, bFinal, RowEnd, NextRow))
+			{
+				HandleRow(Pos, RowEnd);
+				Pos = NextRow;
+			}
+
+			// Keep the incomplete row for the next chunk
+			Pending.RemoveAt(0, Pos, false);
+		}
+
+		// Finds the line break that ends the row starting at Pos, skipping the ones inside quotes
+		bool FindRowEnd(int32 Pos, bool bFinal, int32& OutRowEnd, int32& OutNextRow) const
+		{
+			const ANSICHAR* Data = Pending.GetData();
+			const int32 Num = Pending.Num();
+
+			bool bInQuotes = false;
+			for (int32 Index = Pos; Index < Num; ++Index)
+			{
+				const ANSICHAR Char = Data[Index];
+				if (Char == '"')
+				{
+					// An escaped quote flips this twice, which is the same as not at all
+					bInQuotes = !bInQuotes;
+				}
+				else if (!bInQuotes && (Char == '\n' || Char == '\r'))
+				{
+					OutRowEnd = Index;
+					OutNextRow = Index + 1;
+					if (Char == '\r')
+					{
+						if (Index + 1 < Num)
+						{
+							OutNextRow += Data[Index + 1] == '\n' ? 1 : 0;
+						}
+						else if (!bFinal)
+						{
+							// Can't tell yet whether a \n follows
+							return false;
+						}
+					}
+					return true;
+				}
+			}
+
+			if (bFinal && Pos < Num)
+			{
+				OutRowEnd = Num;
+				OutNextRow = Num;
+				return true;
+			}
+			return false;
+		}
+
+		// Splits the row into cells, taking quotes out in place. The row is complete, so it is never looked at again.
+		void SplitRow(int32 Begin, int32 End)
+		{
+			ANSICHAR* Data = Pending.GetData();
+			Cells.Reset();
+
+			int32 Pos = Begin;
+			for (;;)
+			{
+				FCell& Cell = Cells.AddDefaulted_GetRef();
+				if (Pos < End && Data[Pos] == '"')
+				{
+					++Pos;
+					Cell.Begin = Pos;
+
+					int32 Write = Pos;
+					while (Pos < End)
+					{
+						if (Data[Pos] == '"')
+						{
+							if (Pos + 1 < End && Data[Pos + 1] == '"')
+							{
+								Data[Write++] = '"';
+								Pos += 2;
+								continue;
+							}
+							++Pos;
+							break;
+						}
+						Data[Write++] = Data[Pos++];
+					}
+					Cell.Len = Write - Cell.Begin;
+
+					// Anything between the closing quote and the delimiter is dropped
+					while (Pos < End && Data[Pos] != Delimiter)
+					{
+						++Pos;
+					}
+				}
+				else
+				{
+					Cell.Begin = Pos;
+					while (Pos < End && Data[Pos] != Delimiter)
+					{
+						++Pos;
+					}
+					Cell.Len = Pos - Cell.Begin;
+				}
+
+				if (Pos >= End)
+				{
+					break;
+				}
+				++Pos;
+			}
+		}
+
+		void HandleRow(int32 Begin, int32 End)
+		{
+			++RowNumber;
+
+			if (Begin == End)
+			{
+				return;
+			}
+
+			if (!bHasHeader)
+			{
+				ReadHeader(Begin, End);
+				return;
+			}
+
+			const int32 DataIndex = Result.NumRows++;
+			if (DataIndex >= Targets.Num())
+			{
+				FirstExtraRow = NumExtraRows++ == 0 ? RowNumber : FirstExtraRow;
+				return;
+			}
+
+			UObject* Target = Targets[DataIndex];
+			if (!Target)
+			{
+				AddError(RowNumber, 0, TEXT("No target for this row"));
+				return;
+			}
+
+			const TArray<FColumnBinding>& Bindings = GetBindings(Target->GetClass());
+
+			SplitRow(Begin, End);
+
+			if (Cells.Num() > Bindings.Num())
+			{
+				AddError(RowNumber, Bindings.Num() + 1, FString::Printf(TEXT("%d more cells than the header has columns, ignored"), Cells.Num() - Bindings.Num()));
+			}
+
+			const ANSICHAR* Data = Pending.GetData();
+			const int32 NumCells = FMath::Min(Cells.Num(), Bindings.Num());
+			for (int32 Column = 0; Column < NumCells; ++Column)
+			{
+				const FColumnBinding& Binding = Bindings[Column];
+				const FCell& Cell = Cells[Column];
+
+				// Empty cells and unknown columns leave the variable as it is
+				if (Cell.Len == 0 || !Binding.Property)
+				{
+					continue;
+				}
+
+				if (ApplyCell(Target, Binding, Data + Cell.Begin, Cell.Len))
+				{
+					++Result.NumCellsApplied;
+				}
+				else
+				{
+					const FUTF8ToTCHAR CellText(Data + Cell.Begin, Cell.Len);
+					AddError(RowNumber, Column + 1, FString::Printf(TEXT("'%s' is not a valid %s for %s"),
+						*FString(CellText.Length(), CellText.Get()), *Binding.Property->GetCPPType(), *Binding.Property->GetName()));
+				}
+			}
+
+			++Result.NumRowsApplied;
+		}
+
+		void ReadHeader(int32 Begin, int32 End)
+		{
+			if (Delimiter == 0)
+			{
+				const ANSICHAR* Data = Pending.GetData();
+				Delimiter = ',';
+				for (int32 Index = Begin; Index < End; ++Index)
+				{
+					if (Data[Index] == '\t')
+					{
+						Delimiter = '\t';
+						break;
+					}
+				}
+			}
+
+			SplitRow(Begin, End);
+
+			const ANSICHAR* Data = Pending.GetData();
+			for (const FCell& Cell : Cells)
+			{
+				const ANSICHAR* Name = Data + Cell.Begin;
+				int32 NameLen = Cell.Len;
+				TrimCell(Name, NameLen);
+
+				FUTF8ToTCHAR Converter(Name, NameLen);
+				ColumnNames.Add(FName(Converter.Length(), Converter.Get()));
+			}
+
+			HeaderRow = RowNumber;
+			bHasHeader = true;
+		}
+
+		// Columns are matched to variables the first time a class shows up
+		const TArray<FColumnBinding>& GetBindings(const UClass* Class)
+		{
+			if (Class == LastClass)
+			{
+				return *LastBindings;
+			}
+
+			TArray<FColumnBinding>* Bindings = ClassBindings.Find(Class);
+			if (!Bindings)
+			{
+				Bindings = &ClassBindings.Add(Class);
+				Bindings->SetNum(ColumnNames.Num());
+
+				for (int32 Column = 0; Column < ColumnNames.Num(); ++Column)
+				{
+					FColumnBinding& Binding = (*Bindings)[Column];
+					UProperty* Property = FPSPropertyCache::FindProperty(Class, ColumnNames[Column]);
+					if (!Property || Property->ArrayDim != 1)
+					{
+						AddError(HeaderRow, Column + 1, FString::Printf(TEXT("%s has no single value variable %s, column skipped for it"), *Class->GetName(), *ColumnNames[Column].ToString()));
+						continue;
+					}
+
+					Binding.Property = Property;
+					FPSPropertyCache::FindNumeric(Class, ColumnNames[Column], Binding.Numeric);
+
+					const UByteProperty* ByteProperty = Cast<UByteProperty>(Property);
+					Binding.bEnum = Property->IsA<UEnumProperty>() || (ByteProperty && ByteProperty->Enum);
+				}
+			}
+
+			LastClass = Class;
+			LastBindings = Bindings;
+			return *Bindings;
+		}
+
+		bool ApplyCell(UObject* Target, const FColumnBinding& Binding, const ANSICHAR* Begin, int32 Len)
+		{
+			if (Binding.Numeric.Kind != EPSNumericKind::None)
+			{
+				if (IsFloatingPoint(Binding.Numeric.Kind))
+				{
+					double Value = 0.0;
+					if (ParseFloat(Begin, Len, Value))
+					{
+						Binding.Numeric.Write(Target, Value);
+						return true;
+					}
+				}
+				else
+				{
+					int64 Value = 0;
+					if (ParseInt(Begin, Len, Value))
+					{
+						Binding.Numeric.Write(Target, Value);
+						return true;
+					}
+				}
+
+				if (!Binding.bEnum)
+				{
+					return false;
+				}
+			}
+			else if (const UBoolProperty* BoolProperty = Cast<UBoolProperty>(Binding.Property))
+			{
+				bool Value = false;
+				if (!ParseBool(Begin, Len, Value))
+				{
+					return false;
+				}
+				BoolProperty->SetPropertyValue_InContainer(Target, Value);
+				return true;
+			}
+
+			// Everything else goes through text, in a buffer kept from cell to cell
+			FUTF8ToTCHAR Converter(Begin, Len);
+			TextBuffer.Reset(Converter.Length() + 1);
+			TextBuffer.Append(Converter.Get(), Converter.Length());
+			TextBuffer.Add(0);
+			const TCHAR* Text = TextBuffer.GetData();
+
+			// Strings, names and texts take the cell as it is, ImportText would stop them at the first space
+			if (const UStrProperty* StrProperty = Cast<UStrProperty>(Binding.Property))
+			{
+				StrProperty->SetPropertyValue_InContainer(Target, FString(Converter.Length(), Text));
+			}
+			else if (const UNameProperty* NameProperty = Cast<UNameProperty>(Binding.Property))
+			{
+				NameProperty->SetPropertyValue_InContainer(Target, FName(Text));
+			}
+			else if (const UTextProperty* TextProperty = Cast<UTextProperty>(Binding.Property))
+			{
+				TextProperty->SetPropertyValue_InContainer(Target, FText::FromString(FString(Converter.Length(), Text)));
+			}
+			else
+			{
+				return Binding.Property->ImportText(Text, Binding.Property->ContainerPtrToValuePtr<void>(Target), PPF_None, Target) != nullptr;
+			}
+			return true;
+		}
+
+		void AddError(int32 Row, int32 Column, const FString& Message)
+		{
+			++Result.NumErrors;
+			if (Result.Errors.Num() < FPSTableImport::MaxReportedErrors)
+			{
+				Result.Errors.Add({ Row, Column, Message });
+			}
+		}
+
+		const TArray<UObject*>& Targets;
+		FPSTableImportResult& Result;
+
+		ANSICHAR Delimiter;
+		int32 RowNumber;
+		int32 HeaderRow;
+		int32 FirstExtraRow;
+		int32 NumExtraRows;
+		bool bCheckedByteOrderMark;
+		bool bHasHeader;
+
+		/** Text not applied yet, starting at the first incomplete row */
+		TArray<ANSICHAR> Pending;
+		TArray<FCell> Cells;
+		TArray<TCHAR> TextBuffer;
+
+		TArray<FName> ColumnNames;
+		TMap<const UClass*, TArray<FColumnBinding>> ClassBindings;
+		const UClass* LastClass;
+		TArray<FColumnBinding>* LastBindings;
+	};
+}
+
+bool FPSTableImport::ImportFile(const FString& Filename, const TArray<UObject*>& Targets, FPSTableImportResult& OutResult, TCHAR Delimiter)
+{
+	OutResult = FPSTableImportResult();
+	const double StartTime = FPlatformTime::Seconds();
+
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!FileReader)
+	{
+		return false;
+	}
+
+	FPSTableImporter Importer(Targets, Delimiter, OutResult);
+
+	TArray<ANSICHAR> Chunk;
+	Chunk.SetNumUninitialized(ReadChunkSize);
+
+	int64 Remaining = FileReader->TotalSize();
+	while (Remaining > 0 && !FileReader->IsError())
+	{
+		const int32 ChunkSize = (int32)FMath::Min<int64>(Remaining, ReadChunkSize);
+		FileReader->Serialize(Chunk.GetData(), ChunkSize);
+		Importer.Feed(Chunk.GetData(), ChunkSize);
+		Remaining -= ChunkSize;
+	}
+
+	const bool bSuccess = Importer.Finish();
+	OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+	return bSuccess;
+}
+
+bool FPSTableImport::ImportString(const FString& Text, const TArray<UObject*>& Targets, FPSTableImportResult& OutResult, TCHAR Delimiter)
+{
+	OutResult = FPSTableImportResult();
+	const double StartTime = FPlatformTime::Seconds();
+
+	FPSTableImporter Importer(Targets, Delimiter, OutResult);
+
+	FTCHARToUTF8 Converter(*Text, Text.Len());
+	Importer.Feed(Converter.Get(), Converter.Length());
+
+	const bool bSuccess = Importer.Finish();
+	OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+	return bSuccess;
+}
@@ -0,0 +1,65 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** A cell (or row) that could not be applied. */
+struct FPSTableImportError
+{
+	/** Record number as a spreadsheet shows it, the header being row 1. */
+	int32 Row;
+
+	/** 1 based, 0 when the error is about the whole row. */
+	int32 Column;
+
+	FString Message;
+};
+
+struct FPSTableImportResult
+{
+	/** Data rows read, not counting the header or blank lines. */
+	int32 NumRows = 0;
+
+	/** Rows that had a target to go to. */
+	int32 NumRowsApplied = 0;
+
+	int64 NumCellsApplied = 0;
+
+	/** Every error, including those past the reported ones. */
+	int32 NumErrors = 0;
+
+	/** The first MaxReportedErrors errors, in the order they were found. */
+	TArray<FPSTableImportError> Errors;
+
+	double Seconds = 0.0;
+};
+
+/**
+ * Streaming CSV/TSV import of named variables for a whole population.
+ *
+ * The header row names the variables. Data row N goes to Targets[N - 1], matching the order the population was exported in.
+ * Columns are matched to variables once per class, numeric cells are parsed straight from the file's bytes into the variable
+ * with no allocation, and the file is read and applied in chunks so memory use doesn't grow with its size.
+ * Cells that don't parse, or name a variable the target's class doesn't have, are reported and the rest of the row still goes in.
+ * Empty cells leave the variable as it is. Integers out of the variable's range wrap, like a C cast.
+ *
+ * The text is UTF-8 (a byte order mark is skipped). Cells may be quoted, with "" for a quote inside them, and quoted cells may span lines.
+ * Writes go straight to memory, they are not journaled.
+ */
+struct NFPOPULATIONSYSTEM_API FPSTableImport
+{
+	/** Errors past this many are counted but not kept. */
+	static const int32 MaxReportedErrors = 1000;
+
+	/**
+	 * Imports Filename into Targets.
+	 *
+	 * @param Delimiter	Cell separator, or 0 to take a tab if the header has one and a comma otherwise.
+	 * @return	False if the file could not be opened or has no header.
+	 */
+	static bool ImportFile(const FString& Filename, const TArray<UObject*>& Targets, FPSTableImportResult& OutResult, TCHAR Delimiter = 0);
+
+	/** Same as ImportFile, for text already in memory. */
+	static bool ImportString(const FString& Text, const TArray<UObject*>& Targets, FPSTableImportResult& OutResult, TCHAR Delimiter = 0);
+};
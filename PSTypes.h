@@ -0,0 +1,110 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "PSTypes.generated.h"
+
+/** In-place arithmetic applied to a named property across a whole population. */
+UENUM(BlueprintType)
+enum class EPSBulkOp : uint8
+{
+	/** Value = Value + A */
+	Add,
+	/** Value = Value * A */
+	Scale,
+	/** Value = Clamp(Value, A, B) */
+	Clamp,
+	/** Value = Lerp(Value, A, B) */
+	Lerp,
+	/** Value = Value * A + B */
+	Fma
+};
+
+/** Comparison used when querying a population by a named property. */
+UENUM(BlueprintType)
+enum class EPSCompareOp : uint8
+{
+	Less,
+	LessOrEqual,
+	Greater,
+	GreaterOrEqual,
+	Equal,
+	NotEqual
+};
+
+/** Called at the end of the frame in which an observed variable was changed through the UPSData setters. */
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FPSPropertyChangedDynamic, UObject*, Target, FName, VarName);
+
+/** Population statistics of a named numeric variable. */
+USTRUCT(BlueprintType)
+struct FPSReductionResult
+{
+	GENERATED_BODY()
+
+	/** How many targets had the variable. Everything else is only meaningful when this is above zero. */
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		float Sum = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		float Min = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		float Max = 0.f;
+
+	/** Index into the targets of the (first) smallest value. */
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		int32 MinIndex = INDEX_NONE;
+
+	/** Index into the targets of the (first) largest value. */
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		int32 MaxIndex = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		float Mean = 0.f;
+
+	/** Population variance. */
+	UPROPERTY(BlueprintReadOnly, Category = "nfPopulationSystem")
+		float Variance = 0.f;
+};
+
+/**
+ * Inline cache for one by-name call site, filled in by the *Cached UPSData accessors.
+ * Node expansion gives every getter/setter node its own, so a call site that keeps seeing the same class or two
+ * finds its property here without touching the shared FPSPropertyCache. Call sites that see more classes than it holds
+ * stop filling it and go straight to the shared cache.
+ * In the event graph it lasts as long as the object, in a function it is a local that only lasts one call.
+ * Nothing in it is saved, it starts empty in every instance.
+ */
+USTRUCT(BlueprintType)
+struct NFPOPULATIONSYSTEM_API FPSInlineCache
+{
+	GENERATED_BODY()
+
+	static const int32 NumEntries = 4;
+
+	struct FEntry
+	{
+		FWeakObjectPtr Class;
+		FName VarName;
+		UProperty* Property = nullptr;
+
+		/** Whether writes to the variable need to tell FPSPropertyObservers */
+		bool bObserved = false;
+	};
+
+	FEntry Entries[NumEntries];
+
+	/** FPSPropertyCache generation the entries were made in */
+	uint32 Generation = 0;
+
+	/** FPSPropertyCache observer generation the entries' bObserved flags are from */
+	uint32 ObserverGeneration = 0;
+
+	int32 NumUsed = 0;
+	bool bMegamorphic = false;
+};
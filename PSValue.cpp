@@ -0,0 +1,420 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSValue.h"
+
+#include "PSPropertyCache.h"
+
+FPSValue::FPSValue()
+	: HeapStruct(nullptr)
+	, StructType(nullptr)
+	, Type(EPSValueType::None)
+{
+}
+
+FPSValue::~FPSValue()
+{
+	Reset();
+}
+
+FPSValue::FPSValue(const FPSValue& Other)
+	: FPSValue()
+{
+	*this = Other;
+}
+
+FPSValue::FPSValue(FPSValue&& Other)
+	: FPSValue()
+{
+	*this = MoveTemp(Other);
+}
+
+FPSValue& FPSValue::operator=(const FPSValue& Other)
+{
+	if (this == &Other)
+	{
+		return *this;
+	}
+
+	switch (Other.Type)
+	{
+	case EPSValueType::String:	SetString(Other.As<FString>()); break;
+	case EPSValueType::Text:	SetText(Other.As<FText>()); break;
+	case EPSValueType::Struct:	SetStruct(Other.StructType, Other.GetStructData()); break;
+	default:
+		// Everything else is trivially copyable
+		Reset();
+		FMemory::Memcpy(Storage, Other.Storage, InlineSize);
+		Type = Other.Type;
+		break;
+	}
+
+	return *this;
+}
+
+FPSValue& FPSValue::operator=(FPSValue&& Other)
+{
+	if (this == &Other)
+	{
+		return *this;
+	}
+
+	Reset();
+
+	switch (Other.Type)
+	{
+	case EPSValueType::String:
+		new (Storage) FString(MoveTemp(Other.As<FString>()));
+		break;
+	case EPSValueType::Text:
+		new (Storage) FText(MoveTemp(Other.As<FText>()));
+		break;
+	case EPSValueType::Struct:
+		if (Other.HeapStruct)
+		{
+			// Heap structs just change owner
+			HeapStruct = Other.HeapStruct;
+			StructType = Other.StructType;
+			Type = EPSValueType::Struct;
+			Other.HeapStruct = nullptr;
+			Other.StructType = nullptr;
+			Other.Type = EPSValueType::None;
+			return *this;
+		}
+		SetStruct(Other.StructType, Other.GetStructData());
+		break;
+	default:
+		FMemory::Memcpy(Storage, Other.Storage, InlineSize);
+		break;
+	}
+
+	Type = Other.Type;
+	Other.Reset();
+	return *this;
+}
+
+void FPSValue::Reset()
+{
+	switch (Type)
+	{
+	case EPSValueType::String:
+		As<FString>().~FString();
+		break;
+	case EPSValueType::Text:
+		As<FText>().~FText();
+		break;
+	case EPSValueType::Struct:
+		StructType->DestroyStruct(GetMutableStructData());
+		if (HeapStruct)
+		{
+			FMemory::Free(HeapStruct);
+			HeapStruct = nullptr;
+		}
+		StructType = nullptr;
+		break;
+	default:
+		break;
+	}
+
+	Type = EPSValueType::None;
+}
+
+void FPSValue::SetBool(bool Value)
+{
+	Reset();
+	As<bool>() = Value;
+	Type = EPSValueType::Bool;
+}
+
+void FPSValue::SetByte(uint8 Value)
+{
+	Reset();
+	As<uint8>() = Value;
+	Type = EPSValueType::Byte;
+}
+
+void FPSValue::SetInt(int32 Value)
+{
+	Reset();
+	As<int32>() = Value;
+	Type = EPSValueType::Int;
+}
+
+void FPSValue::SetInt64(int64 Value)
+{
+	Reset();
+	As<int64>() = Value;
+	Type = EPSValueType::Int64;
+}
+
+void FPSValue::SetFloat(float Value)
+{
+	Reset();
+	As<float>() = Value;
+	Type = EPSValueType::Float;
+}
+
+void FPSValue::SetDouble(double Value)
+{
+	Reset();
+	As<double>() = Value;
+	Type = EPSValueType::Double;
+}
+
+void FPSValue::SetName(FName Value)
+{
+	Reset();
+	new (Storage) FName(Value);
+	Type = EPSValueType::Name;
+}
+
+void FPSValue::SetString(const FString& Value)
+{
+	if (Type == EPSValueType::String)
+	{
+		As<FString>() = Value;
+		return;
+	}
+
+	Reset();
+	new (Storage) FString(Value);
+	Type = EPSValueType::String;
+}
+
+void FPSValue::SetText(const FText& Value)
+{
+	if (Type == EPSValueType::Text)
+	{
+		As<FText>() = Value;
+		return;
+	}
+
+	Reset();
+	new (Storage) FText(Value);
+	Type = EPSValueType::Text;
+}
+
+void FPSValue::SetObject(UObject* Value)
+{
+	Reset();
+	As<UObject*>() = Value;
+	Type = EPSValueType::Object;
+}
+
+void FPSValue::SetStruct(const UScriptStruct* Struct, const void* StructData)
+{
+	check(Struct && StructData);
+
+	// Same struct already held, copy over it instead of rebuilding
+	if (Type == EPSValueType::Struct && StructType == Struct)
+	{
+		Struct->CopyScriptStruct(GetMutableStructData(), StructData);
+		return;
+	}
+
+	Reset();
+
+	const int32 StructSize = Struct->GetStructureSize();
+	const int32 StructAlignment = Struct->GetMinAlignment();
+	if (StructSize > InlineSize || StructAlignment > 16)
+	{
+		HeapStruct = FMemory::Malloc(StructSize, StructAlignment);
+	}
+
+	StructType = Struct;
+	Type = EPSValueType::Struct;
+
+	Struct->InitializeStruct(GetMutableStructData());
+	Struct->CopyScriptStruct(GetMutableStructData(), StructData);
+}
+
+const void* FPSValue::GetStructData() const
+{
+	if (Type != EPSValueType::Struct)
+	{
+		return nullptr;
+	}
+	return HeapStruct ? HeapStruct : Storage;
+}
+
+void* FPSValue::GetMutableStructData()
+{
+	return HeapStruct ? HeapStruct : Storage;
+}
+
+bool FPSValue::TryGetNumber(double& OutValue) const
+{
+	switch (Type)
+	{
+	case EPSValueType::Bool:	OutValue = As<bool>() ? 1.0 : 0.0; return true;
+	case EPSValueType::Byte:	OutValue = As<uint8>(); return true;
+	case EPSValueType::Int:		OutValue = As<int32>(); return true;
+	case EPSValueType::Int64:	OutValue = (double)As<int64>(); return true;
+	case EPSValueType::Float:	OutValue = As<float>(); return true;
+	case EPSValueType::Double:	OutValue = As<double>(); return true;
+	default:					return false;
+	}
+}
+
+bool FPSValue::ReadFrom(const UProperty* Property, const void* Address)
+{
+	if (!Property || !Address || Property->ArrayDim != 1)
+	{
+		return false;
+	}
+
+	if (const UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+	{
+		SetBool(BoolProperty->GetPropertyValue(Address));
+	}
+	else if (const UByteProperty* ByteProperty = Cast<UByteProperty>(Property))
+	{
+		SetByte(ByteProperty->GetPropertyValue(Address));
+	}
+	else if (const UIntProperty* IntProperty = Cast<UIntProperty>(Property))
+	{
+		SetInt(IntProperty->GetPropertyValue(Address));
+	}
+	else if (const UFloatProperty* FloatProperty = Cast<UFloatProperty>(Property))
+	{
+		SetFloat(FloatProperty->GetPropertyValue(Address));
+	}
+	else if (const UDoubleProperty* DoubleProperty = Cast<UDoubleProperty>(Property))
+	{
+		SetDouble(DoubleProperty->GetPropertyValue(Address));
+	}
+	else if (const UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+	{
+		SetInt64(EnumProperty->GetUnderlyingProperty()->GetSignedIntPropertyValue(Address));
+	}
+	else if (const UNumericProperty* NumericProperty = Cast<UNumericProperty>(Property))
+	{
+		// The remaining int widths all fit an int64
+		SetInt64(NumericProperty->GetSignedIntPropertyValue(Address));
+	}
+	else if (const UNameProperty* NameProperty = Cast<UNameProperty>(Property))
+	{
+		SetName(NameProperty->GetPropertyValue(Address));
+	}
+	else if (const UStrProperty* StrProperty = Cast<UStrProperty>(Property))
+	{
+		SetString(StrProperty->GetPropertyValue(Address));
+	}
+	else if (const UTextProperty* TextProperty = Cast<UTextProperty>(Property))
+	{
+		SetText(TextProperty->GetPropertyValue(Address));
+	}
+	else if (const UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
+	{
+		SetObject(ObjectProperty->GetObjectPropertyValue(Address));
+	}
+	else if (const UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	{
+		SetStruct(StructProperty->Struct, Address);
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool FPSValue::WriteTo(const UProperty* Property, void* Address) const
+{
+	if (!Property || !Address || Property->ArrayDim != 1 || Type == EPSValueType::None)
+	{
+		return false;
+	}
+
+	double Number = 0.0;
+	const bool bIsNumber = TryGetNumber(Number);
+
+	if (const UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+	{
+		if (Type != EPSValueType::Bool)
+		{
+			return false;
+		}
+		BoolProperty->SetPropertyValue(Address, As<bool>());
+	}
+	else if (const UEnumProperty* EnumProperty = Cast<UEnumProperty>(Property))
+	{
+		if (!bIsNumber || Type == EPSValueType::Float || Type == EPSValueType::Double)
+		{
+			return false;
+		}
+		EnumProperty->GetUnderlyingProperty()->SetIntPropertyValue(Address, Type == EPSValueType::Int64 ? As<int64>() : FPSNumericAccess::Convert<int64>(Number));
+	}
+	else if (const UNumericProperty* NumericProperty = Cast<UNumericProperty>(Property))
+	{
+		if (!bIsNumber || Type == EPSValueType::Bool)
+		{
+			return false;
+		}
+
+		if (NumericProperty->IsFloatingPoint())
+		{
+			NumericProperty->SetFloatingPointPropertyValue(Address, Number);
+		}
+		else
+		{
+			// Go through int64 directly when we have one, a double can't hold every int64
+			NumericProperty->SetIntPropertyValue(Address, Type == EPSValueType::Int64 ? As<int64>() : FPSNumericAccess::Convert<int64>(Number));
+		}
+	}
+	else if (const UNameProperty* NameProperty = Cast<UNameProperty>(Property))
+	{
+		if (Type != EPSValueType::Name)
+		{
+			return false;
+		}
+		NameProperty->SetPropertyValue(Address, As<FName>());
+	}
+	else if (const UStrProperty* StrProperty = Cast<UStrProperty>(Property))
+	{
+		if (Type != EPSValueType::String)
+		{
+			return false;
+		}
+		StrProperty->SetPropertyValue(Address, As<FString>());
+	}
+	else if (const UTextProperty* TextProperty = Cast<UTextProperty>(Property))
+	{
+		if (Type != EPSValueType::Text)
+		{
+			return false;
+		}
+		TextProperty->SetPropertyValue(Address, As<FText>());
+	}
+	else if (const UObjectPropertyBase* ObjectProperty = Cast<UObjectPropertyBase>(Property))
+	{
+		UObject* Object = Type == EPSValueType::Object ? As<UObject*>() : nullptr;
+		if (Type != EPSValueType::Object || (Object && !Object->IsA(ObjectProperty->PropertyClass)))
+		{
+			return false;
+		}
+
+		// A TSubclassOf only takes classes derived from its base
+		const UClassProperty* ClassProperty = Cast<UClassProperty>(ObjectProperty);
+		if (ClassProperty && Object && !CastChecked<UClass>(Object)->IsChildOf(ClassProperty->MetaClass))
+		{
+			return false;
+		}
+		ObjectProperty->SetObjectPropertyValue(Address, Object);
+	}
+	else if (const UStructProperty* StructProperty = Cast<UStructProperty>(Property))
+	{
+		if (Type != EPSValueType::Struct || StructProperty->Struct != StructType)
+		{
+			return false;
+		}
+		StructType->CopyScriptStruct(Address, GetStructData());
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,109 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/UnrealType.h"
+
+enum class EPSValueType : uint8
+{
+	None,
+	Bool,
+	Byte,
+	Int,
+	Int64,
+	Float,
+	Double,
+	Name,
+	String,
+	Text,
+	Object,
+	Struct
+};
+
+/**
+ * A value of any type UPSData can read or write, so generic code (inspectors, mirrors) can handle every variable through one code path.
+ * Scalars, names, strings, texts and structs up to InlineSize bytes live inside the value itself. Only bigger structs go to the heap.
+ * Object values are not referenced for garbage collection, same as a raw UObject* member.
+ */
+class NFPOPULATIONSYSTEM_API FPSValue
+{
+public:
+
+	static const int32 InlineSize = 32;
+
+	FPSValue();
+	~FPSValue();
+
+	FPSValue(const FPSValue& Other);
+	FPSValue(FPSValue&& Other);
+	FPSValue& operator=(const FPSValue& Other);
+	FPSValue& operator=(FPSValue&& Other);
+
+	EPSValueType GetType() const { return Type; }
+	bool IsSet() const { return Type != EPSValueType::None; }
+
+	void Reset();
+
+	void SetBool(bool Value);
+	void SetByte(uint8 Value);
+	void SetInt(int32 Value);
+	void SetInt64(int64 Value);
+	void SetFloat(float Value);
+	void SetDouble(double Value);
+	void SetName(FName Value);
+	void SetString(const FString& Value);
+	void SetText(const FText& Value);
+	void SetObject(UObject* Value);
+
+	/** Copies StructData, which must be an instance of Struct. */
+	void SetStruct(const UScriptStruct* Struct, const void* StructData);
+
+	// Typed getters, the value must hold that type
+	bool GetBool() const { check(Type == EPSValueType::Bool); return As<bool>(); }
+	uint8 GetByte() const { check(Type == EPSValueType::Byte); return As<uint8>(); }
+	int32 GetInt() const { check(Type == EPSValueType::Int); return As<int32>(); }
+	int64 GetInt64() const { check(Type == EPSValueType::Int64); return As<int64>(); }
+	float GetFloat() const { check(Type == EPSValueType::Float); return As<float>(); }
+	double GetDouble() const { check(Type == EPSValueType::Double); return As<double>(); }
+	FName GetName() const { check(Type == EPSValueType::Name); return As<FName>(); }
+	const FString& GetString() const { check(Type == EPSValueType::String); return As<FString>(); }
+	const FText& GetText() const { check(Type == EPSValueType::Text); return As<FText>(); }
+	UObject* GetObject() const { check(Type == EPSValueType::Object); return As<UObject*>(); }
+	const UScriptStruct* GetStructType() const { return Type == EPSValueType::Struct ? StructType : nullptr; }
+	const void* GetStructData() const;
+
+	/** Any numeric value (bool, byte, int, int64, float, double) as a double. */
+	bool TryGetNumber(double& OutValue) const;
+
+	/** Reads the value of Property, found at Address (already offset into its container). */
+	bool ReadFrom(const UProperty* Property, const void* Address);
+
+	/** Writes this value to Property at Address. Fails if the types don't match, numeric values convert between widths. */
+	bool WriteTo(const UProperty* Property, void* Address) const;
+
+private:
+
+	template<typename ValueType>
+	ValueType& As()
+	{
+		static_assert(sizeof(ValueType) <= InlineSize, "Value does not fit the inline storage");
+		return *reinterpret_cast<ValueType*>(Storage);
+	}
+
+	template<typename ValueType>
+	const ValueType& As() const
+	{
+		static_assert(sizeof(ValueType) <= InlineSize, "Value does not fit the inline storage");
+		return *reinterpret_cast<const ValueType*>(Storage);
+	}
+
+	void* GetMutableStructData();
+
+	alignas(16) uint8 Storage[InlineSize];
+
+	/** Only set for structs that didn't fit in Storage */
+	void* HeapStruct;
+	const UScriptStruct* StructType;
+	EPSValueType Type;
+};
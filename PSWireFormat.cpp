@@ -0,0 +1,478 @@
+// Copyright Nicholas Ferrar 2019
+
+
+#include "PSWireFormat.h"
+
+#include "Misc/ScopeRWLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "Serialization/StructuredArchive.h"
+#include "Templates/UniquePtr.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UnrealType.h"
+
+namespace
+{
+	// Folded into every schema hash, bump when the encoding changes
+	const uint32 WireFormatVersion = 2;
+
+	struct FPSIdTableStorage
+	{
+		FPSIdTableStorage()
+			: Generation(0)
+		{
+		}
+
+		FRWLock Lock;
+		TMap<const UClass*, TUniquePtr<FPSPropertyIdTable>> Tables;
+
+		/** FPSPropertyCache generation the tables were built in */
+		uint32 Generation;
+	};
+
+	FPSIdTableStorage& GetStorage()
+	{
+		static FPSIdTableStorage Storage;
+		return Storage;
+	}
+
+	// Room for a single value of a property's type, for values that have to go through one before reaching (or instead of reaching) an object
+	struct FPSScratchValue
+	{
+		FPSScratchValue()
+			: Property(nullptr)
+			, Data(nullptr)
+		{
+		}
+
+		~FPSScratchValue()
+		{
+			Reset();
+		}
+
+		void* Prepare(const UProperty* InProperty)
+		{
+			if (Property != InProperty)
+			{
+				Reset();
+				Property = InProperty;
+				Data = FMemory::Malloc(Property->GetSize(), Property->GetMinAlignment());
+				Property->InitializeValue(Data);
+			}
+			return Data;
+		}
+
+		void Reset()
+		{
+			if (Property)
+			{
+				Property->DestroyValue(Data);
+				FMemory::Free(Data);
+				Property = nullptr;
+				Data = nullptr;
+			}
+		}
+
+		const UProperty* Property;
+		void* Data;
+	};
+
+	// LEB128, 7 bits a byte with the top bit set on all but the last
+	void SerializeVarUInt(FArchive& Ar, uint64& Value)
+	{
+		if (Ar.IsLoading())
+		{
+			Value = 0;
+			for (int32 Shift = 0; Shift < 64; Shift += 7)
+			{
+				uint8 Byte = 0;
+				Ar << Byte;
+				Value |= (uint64)(Byte & 0x7f) << Shift;
+				if ((Byte & 0x80) == 0 || Ar.IsError())
+				{
+					return;
+				}
+			}
+			Ar.SetError();
+		}
+		else
+		{
+			uint64 Remaining = Value;
+			do
+			{
+				uint8 Byte = (uint8)(Remaining & 0x7f);
+				Remaining >>= 7;
+				if (Remaining != 0)
+				{
+					Byte |= 0x80;
+				}
+				Ar << Byte;
+			}
+			while (Remaining != 0);
+		}
+	}
+
+	// Zigzag keeps small negative numbers small once they go through SerializeVarUInt
+	uint64 ZigZagEncode(int64 Value)
+	{
+		return ((uint64)Value << 1) ^ (uint64)(Value >> 63);
+	}
+
+	int64 ZigZagDecode(uint64 Value)
+	{
+		return (int64)(Value >> 1) ^ -(int64)(Value & 1);
+	}
+
+	void SerializeSigned(FArchive& Ar, EPSNumericKind Kind, void* Address)
+	{
+		int64 Value = 0;
+		if (Ar.IsSaving())
+		{
+			switch (Kind)
+			{
+			case EPSNumericKind::Int8:	Value = *static_cast<int8*>(Address); break;
+			case EPSNumericKind::Int16:	Value = *static_cast<int16*>(Address); break;
+			case EPSNumericKind::Int32:	Value = *static_cast<int32*>(Address); break;
+			default:					Value = *static_cast<int64*>(Address); break;
+			}
+		}
+
+		uint64 Bits = ZigZagEncode(Value);
+		SerializeVarUInt(Ar, Bits);
+
+		if (Ar.IsLoading())
+		{
+			Value = ZigZagDecode(Bits);
+			switch (Kind)
+			{
+			case EPSNumericKind::Int8:	*static_cast<int8*>(Address) = (int8)Value; break;
+			case EPSNumericKind::Int16:	*static_cast<int16*>(Address) = (int16)Value; break;
+			case EPSNumericKind::Int32:	*static_cast<int32*>(Address) = (int32)Value; break;
+			default:					*static_cast<int64*>(Address) = Value; break;
+			}
+		}
+	}
+
+	void SerializeUnsigned(FArchive& Ar, EPSNumericKind Kind, void* Address)
+	{
+		uint64 Value = 0;
+		if (Ar.IsSaving())
+		{
+			switch (Kind)
+			{
+			case EPSNumericKind::UInt8:		Value = *static_cast<uint8*>(Address); break;
+			case EPSNumericKind::UInt16:	Value = *static_cast<uint16*>(Address); break;
+			case EPSNumericKind::UInt32:	Value = *static_cast<uint32*>(Address); break;
+			default:						Value = *static_cast<uint64*>(Address); break;
+			}
+		}
+
+		SerializeVarUInt(Ar, Value);
+
+		if (Ar.IsLoading())
+		{
+			switch (Kind)
+			{
+			case EPSNumericKind::UInt8:		*static_cast<uint8*>(Address) = (uint8)Value; break;
+			case EPSNumericKind::UInt16:	*static_cast<uint16*>(Address) = (uint16)Value; break;
+			case EPSNumericKind::UInt32:	*static_cast<uint32*>(Address) = (uint32)Value; break;
+			default:						*static_cast<uint64*>(Address) = Value; break;
+			}
+		}
+	}
+
+	// Writes or reads the value of property Id at Address, in the most compact form its type allows
+	void SerializeValue(FArchive& Ar, const FPSPropertyIdTable& Table, int32 Id, void* Address)
+	{
+		const EPSNumericKind Kind = Table.GetNumericKind(Id);
+		switch (Kind)
+		{
+		case EPSNumericKind::Float:
+			Ar << *static_cast<float*>(Address);
+			return;
+		case EPSNumericKind::Double:
+			Ar << *static_cast<double*>(Address);
+			return;
+		case EPSNumericKind::Int8:
+		case EPSNumericKind::Int16:
+		case EPSNumericKind::Int32:
+		case EPSNumericKind::Int64:
+			SerializeSigned(Ar, Kind, Address);
+			return;
+		case EPSNumericKind::UInt8:
+		case EPSNumericKind::UInt16:
+		case EPSNumericKind::UInt32:
+		case EPSNumericKind::UInt64:
+			SerializeUnsigned(Ar, Kind, Address);
+			return;
+		default:
+			break;
+		}
+
+		UProperty* Property = Table.GetProperty(Id);
+		if (UBoolProperty* BoolProperty = Cast<UBoolProperty>(Property))
+		{
+			// Just the bit, bitfields share their storage
+			uint8 bValue = Ar.IsSaving() && BoolProperty->GetPropertyValue(Address) ? 1 : 0;
+			Ar << bValue;
+			if (Ar.IsLoading())
+			{
+				BoolProperty->SetPropertyValue(Address, bValue != 0);
+			}
+			return;
+		}
+
+		FStructuredArchiveFromArchive StructuredAr(Ar);
+		Property->SerializeItem(StructuredAr.GetSlot(), Address);
+	}
+
+	UObject* ResolveObject(uint64 ObjectId, uint64 SerialNumber, const TMap<uint32, UObject*>* ObjectRemap)
+	{
+		if (ObjectId > MAX_uint32)
+		{
+			return nullptr;
+		}
+
+		if (ObjectRemap)
+		{
+			if (UObject* const* Remapped = ObjectRemap->Find((uint32)ObjectId))
+			{
+				return *Remapped;
+			}
+		}
+
+		// Ids come off the wire, anything outside the object array is just an unknown object
+		if (ObjectId >= (uint64)GUObjectArray.GetObjectArrayNum())
+		{
+			return nullptr;
+		}
+
+		// Slots get reused after garbage collection, the serial number tells the object the id was taken from apart from a newer one
+		FUObjectItem* Item = GUObjectArray.IndexToObject((int32)ObjectId);
+		if (!Item || !Item->Object || Item->IsPendingKill() || Item->IsUnreachable() || (uint64)Item->GetSerialNumber() != SerialNumber)
+		{
+			return nullptr;
+		}
+		return static_cast<UObject*>(Item->Object);
+	}
+}
+
+FPSPropertyIdTable::FPSPropertyIdTable(const UClass* InClass)
+	: Class(const_cast<UClass*>(InClass))
+	, SchemaHash(WireFormatVersion)
+{
+	for (TFieldIterator<UProperty> It(InClass); It; ++It)
+	{
+		UProperty* Property = *It;
+
+		// Commands set single values
+		if (Property->ArrayDim != 1)
+		{
+			continue;
+		}
+
+		FPSNumericAccess Numeric;
+		const bool bNumeric = FPSPropertyCache::FindNumeric(InClass, Property->GetFName(), Numeric);
+
+		Ids.Add(Property->GetFName(), Properties.Num());
+		Properties.Add(Property);
+		NumericKinds.Add(bNumeric ? Numeric.Kind : EPSNumericKind::None);
+
+		SchemaHash = FCrc::StrCrc32(*Property->GetName(), SchemaHash);
+		SchemaHash = FCrc::StrCrc32(*Property->GetCPPType(), SchemaHash);
+	}
+}
+
+const FPSPropertyIdTable* FPSPropertyIdTable::Get(const UClass* Class)
+{
+	if (!Class)
+	{
+		return nullptr;
+	}
+
+	FPSIdTableStorage& Storage = GetStorage();
+	const uint32 Generation = FPSPropertyCache::GetGeneration();
+
+	{
+		FRWScopeLock ScopeLock(Storage.Lock, SLT_ReadOnly);
+		if (Storage.Generation == Generation)
+		{
+			if (const TUniquePtr<FPSPropertyIdTable>* Table = Storage.Tables.Find(Class))
+			{
+				if ((*Table)->Class.Get() == Class)
+				{
+					return Table->Get();
+				}
+			}
+		}
+	}
+
+	TUniquePtr<FPSPropertyIdTable> NewTable(new FPSPropertyIdTable(Class));
+
+	FRWScopeLock ScopeLock(Storage.Lock, SLT_Write);
+	if (Storage.Generation != Generation)
+	{
+		// Classes got reinstanced, every table may be out of date
+		Storage.Tables.Reset();
+		Storage.Generation = Generation;
+	}
+
+	TUniquePtr<FPSPropertyIdTable>& Table = Storage.Tables.FindOrAdd(Class);
+	if (!Table.IsValid() || Table->Class.Get() != Class)
+	{
+		Table = MoveTemp(NewTable);
+	}
+	return Table.Get();
+}
+
+int32 FPSPropertyIdTable::FindId(FName VarName) const
+{
+	const int32* Id = Ids.Find(VarName);
+	return Id ? *Id : INDEX_NONE;
+}
+
+int32 FPSSetCommandCodec::Encode(const TArray<FPSSetCommand>& Commands, TArray<uint8>& OutMessage)
+{
+	// Group by class, keeping the order the commands were given in within each group
+	TMap<const UClass*, TArray<int32>> Groups;
+	for (int32 Index = 0; Index < Commands.Num(); ++Index)
+	{
+		if (Commands[Index].Target)
+		{
+			Groups.FindOrAdd(Commands[Index].Target->GetClass()).Add(Index);
+		}
+	}
+
+	FMemoryWriter MessageWriter(OutMessage);
+	MessageWriter.Seek(OutMessage.Num());
+
+	int32 NumEncoded = 0;
+	TArray<uint8> Payload;
+	FPSScratchValue Scratch;
+
+	for (const TPair<const UClass*, TArray<int32>>& Group : Groups)
+	{
+		const FPSPropertyIdTable* Table = FPSPropertyIdTable::Get(Group.Key);
+
+		Payload.Reset();
+		FMemoryWriter PayloadWriter(Payload);
+		FObjectAndNameAsStringProxyArchive ValueWriter(PayloadWriter, false);
+		int32 NumWrites = 0;
+
+		for (int32 CommandIndex : Group.Value)
+		{
+			const FPSSetCommand& Command = Commands[CommandIndex];
+
+			const int32 Id = Table->FindId(Command.VarName);
+			if (Id == INDEX_NONE)
+			{
+				continue;
+			}
+
+			// Converting through a value of the variable's own type means the receiver never has to convert
+			void* Value = Scratch.Prepare(Table->GetProperty(Id));
+			if (!Command.Value.WriteTo(Table->GetProperty(Id), Value))
+			{
+				continue;
+			}
+
+			uint64 ObjectId = Command.Target->GetUniqueID();
+			uint64 SerialNumber = GUObjectArray.AllocateSerialNumber((int32)ObjectId);
+			uint64 PropertyId = Id;
+			SerializeVarUInt(ValueWriter, ObjectId);
+			SerializeVarUInt(ValueWriter, SerialNumber);
+			SerializeVarUInt(ValueWriter, PropertyId);
+			SerializeValue(ValueWriter, *Table, Id, Value);
+			++NumWrites;
+		}
+
+		if (NumWrites == 0)
+		{
+			continue;
+		}
+
+		FString ClassPath = Group.Key->GetPathName();
+		uint32 SchemaHash = Table->GetSchemaHash();
+		uint64 PayloadSize = Payload.Num();
+		MessageWriter << ClassPath << SchemaHash;
+		SerializeVarUInt(MessageWriter, PayloadSize);
+		MessageWriter.Serialize(Payload.GetData(), Payload.Num());
+
+		NumEncoded += NumWrites;
+	}
+
+	return NumEncoded;
+}
+
+int32 FPSSetCommandCodec::Decode(const TArray<uint8>& Message, const TMap<uint32, UObject*>* ObjectRemap)
+{
+	FMemoryReader MessageReader(Message);
+	FPSScratchValue Scratch;
+	int32 NumApplied = 0;
+
+	while (!MessageReader.AtEnd())
+	{
+		FString ClassPath;
+		uint32 SchemaHash = 0;
+		uint64 PayloadSize = 0;
+		MessageReader << ClassPath << SchemaHash;
+		SerializeVarUInt(MessageReader, PayloadSize);
+
+		const int64 PayloadEnd = MessageReader.Tell() + (int64)PayloadSize;
+		if (MessageReader.IsError() || PayloadSize > (uint64)MessageReader.TotalSize() || PayloadEnd > MessageReader.TotalSize())
+		{
+			return INDEX_NONE;
+		}
+
+		// One name lookup per class, none per write
+		const UClass* Class = FindObject<UClass>(nullptr, *ClassPath);
+		const FPSPropertyIdTable* Table = FPSPropertyIdTable::Get(Class);
+		if (!Table || Table->GetSchemaHash() != SchemaHash)
+		{
+			MessageReader.Seek(PayloadEnd);
+			continue;
+		}
+
+		FObjectAndNameAsStringProxyArchive ValueReader(MessageReader, false);
+
+		while (MessageReader.Tell() < PayloadEnd)
+		{
+			uint64 ObjectId = 0;
+			uint64 SerialNumber = 0;
+			uint64 PropertyId = 0;
+			SerializeVarUInt(ValueReader, ObjectId);
+			SerializeVarUInt(ValueReader, SerialNumber);
+			SerializeVarUInt(ValueReader, PropertyId);
+
+			UProperty* Property = PropertyId < (uint64)Table->Num() ? Table->GetProperty((int32)PropertyId) : nullptr;
+			if (!Property || ValueReader.IsError() || MessageReader.IsError())
+			{
+				return INDEX_NONE;
+			}
+
+			// Values for objects that are gone (or aren't of this class) still have to be read past
+			UObject* Object = ResolveObject(ObjectId, SerialNumber, ObjectRemap);
+			const bool bApply = Object && Object->GetClass() == Class;
+			void* Address = bApply ? Property->ContainerPtrToValuePtr<void>(Object) : Scratch.Prepare(Property);
+
+			SerializeValue(ValueReader, *Table, (int32)PropertyId, Address);
+			if (ValueReader.IsError() || MessageReader.IsError())
+			{
+				return INDEX_NONE;
+			}
+
+			if (bApply)
+			{
+				++NumApplied;
+			}
+		}
+
+		if (MessageReader.Tell() != PayloadEnd)
+		{
+			return INDEX_NONE;
+		}
+	}
+
+	return NumApplied;
+}
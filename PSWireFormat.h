@@ -0,0 +1,76 @@
+// Copyright Nicholas Ferrar 2019
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PSPropertyCache.h"
+#include "PSValue.h"
+
+/**
+ * Small integer ids for the variables of one class, so commands can refer to a variable without carrying its name.
+ * Ids follow the class's property order, so two processes running the same build give every variable the same id.
+ * The schema hash covers every name and type in the table, to catch processes that don't.
+ */
+class NFPOPULATIONSYSTEM_API FPSPropertyIdTable
+{
+public:
+
+	/** Shared table for Class, built on first use. Valid until classes get reinstanced (Blueprint recompile, hot reload). */
+	static const FPSPropertyIdTable* Get(const UClass* Class);
+
+	/** Id of VarName, INDEX_NONE if the class doesn't have it. */
+	int32 FindId(FName VarName) const;
+
+	UProperty* GetProperty(int32 Id) const { return Properties.IsValidIndex(Id) ? Properties[Id] : nullptr; }
+	EPSNumericKind GetNumericKind(int32 Id) const { return NumericKinds[Id]; }
+	int32 Num() const { return Properties.Num(); }
+	uint32 GetSchemaHash() const { return SchemaHash; }
+
+private:
+
+	explicit FPSPropertyIdTable(const UClass* InClass);
+
+	FWeakObjectPtr Class;
+	TArray<UProperty*> Properties;
+	TArray<EPSNumericKind> NumericKinds;
+	TMap<FName, int32> Ids;
+	uint32 SchemaHash;
+};
+
+/** "Set VarName on Target to Value". */
+struct FPSSetCommand
+{
+	UObject* Target = nullptr;
+	FName VarName;
+	FPSValue Value;
+};
+
+/**
+ * Compact wire format for batches of set commands.
+ *
+ * Commands are grouped by the target's class. Each group starts with the class's schema hash and its size, and then lists its writes.
+ * A write is the object's unique id, its serial number and the property id, all variable length, followed by the value in the property's own type:
+ * variable length (zigzag) integers, raw floats and doubles, one byte bools, everything else serialized by the property.
+ * A typical numeric write is 5 to 10 bytes, and decoding never looks a name up.
+ *
+ * Encoding and decoding don't depend on any transport, so a message can be decoded in the same process it was made in.
+ */
+struct NFPOPULATIONSYSTEM_API FPSSetCommandCodec
+{
+	/**
+	 * Appends Commands to OutMessage. Commands with no target, an unknown VarName or a value that doesn't convert to the variable's type are left out.
+	 *
+	 * @return	How many commands were encoded.
+	 */
+	static int32 Encode(const TArray<FPSSetCommand>& Commands, TArray<uint8>& OutMessage);
+
+	/**
+	 * Applies every write in Message, in order within each class. Objects are looked up by unique id, through ObjectRemap first when given.
+	 * Without a remap, the id also has to carry the serial number of the object now in that slot (like FWeakObjectPtr), so a write to an
+	 * object that has since been collected never lands on whatever reused its slot.
+	 * Groups whose schema hash doesn't match the local class are skipped whole, as are writes to objects that can't be found or are being destroyed.
+	 *
+	 * @return	How many writes were applied, or INDEX_NONE if the message is malformed (writes before the bad spot stay applied).
+	 */
+	static int32 Decode(const TArray<uint8>& Message, const TMap<uint32, UObject*>* ObjectRemap = nullptr);
+};